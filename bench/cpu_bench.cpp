@@ -0,0 +1,72 @@
+#include "structs.h"
+
+#include "CPU/CPU.h"
+#include "PPU/PPU.h"
+#include "MMU/MMU.h"
+#include "Scheduler/scheduler.h"
+#include "Cartridge/cartridge.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// Headless throughput benchmark. Runs the same per-instruction loop as main.cpp without
+// SDL or frame pacing and reports steps per second and the emulated speed it reaches.
+// --jit translates hot blocks to native code, --jit-verify also replays every translated
+// block through the interpreter and exits non-zero if the results ever differ.
+int main(int argc, char* argv[]) {
+    bool jit = false, verify = false;
+    const char *rom = nullptr;
+    long long steps = 20000000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--jit") == 0) {
+            jit = true;
+        } else if (std::strcmp(argv[i], "--jit-verify") == 0) {
+            jit = verify = true;
+        } else if (rom == nullptr) {
+            rom = argv[i];
+        } else {
+            steps = std::atoll(argv[i]);
+        }
+    }
+    if (rom == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " <path_to_rom_file> [steps] [--jit | --jit-verify]" << std::endl;
+        return -1;
+    }
+
+    Cartridge cartridge(rom);
+    MMU mmu(&cartridge);
+    Scheduler scheduler(&mmu);
+    CPU cpu(&mmu, &scheduler);
+    PPU ppu(&cpu, &mmu);
+
+    if (jit && !cpu.jit.enable(verify)) {
+        std::cerr << "JIT not supported on this host, using the interpreter" << std::endl;
+    }
+
+    long long total_cycles = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (long long step = 0; step < steps; step++) {
+        int cycles = cpu.step();
+
+        scheduler.increment(cycles);
+        total_cycles += cycles;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << std::dec;
+    std::cout << "Steps: " << steps << " Cycles: " << total_cycles << std::endl;
+    std::cout << "Elapsed: " << seconds << " s" << std::endl;
+    std::cout << "Steps/sec: " << (long long)(steps / seconds) << std::endl;
+    std::cout << "Emulated speed: " << (total_cycles / 4194304.0) / seconds << "x" << std::endl;
+    std::cout << "Busy-wait cycles skipped: " << cpu.busy_wait_cycles << std::endl;
+    std::cout << "Bulk copy/fill loop cycles: " << cpu.bulk_loop_cycles << std::endl;
+    if (jit) {
+        std::cout << "JIT blocks: " << cpu.jit.compiled_blocks << " Mismatches: " << cpu.jit.mismatches << std::endl;
+    }
+    cpu.info();
+    return cpu.jit.mismatches == 0 ? 0 : 1;
+}
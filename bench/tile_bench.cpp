@@ -0,0 +1,63 @@
+#include "structs.h"
+#include "MMU/tile_decoder.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Tile decoder micro-benchmark. Decodes all 384 tiles of a random VRAM image over and
+// over with the old per-pixel loop and with every backend the host supports, checks
+// that each backend matches the loop and reports the time per tile.
+static void decodeLoop(const uint8_t *data, Tile *tiles, int count) {
+    for (int tile = 0; tile < count; tile++, data += 16) {
+        for (int y = 0; y < 8; y++) {
+            uint8_t low = data[y * 2], high = data[y * 2 + 1];
+            for (int x = 0; x < 8; x++) {
+                int shift = 7 - x;
+                tiles[tile].pixels[y][x] = ((low >> shift) & 1) | (((high >> shift) & 1) << 1);
+            }
+        }
+    }
+}
+
+template <typename Decode>
+static double nsPerTile(Decode decode, const uint8_t *vram, Tile *tiles, int passes) {
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        decode(vram, tiles, 384);
+        asm volatile("" : : "r"(tiles) : "memory"); // Keep the stores
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (384.0 * passes);
+}
+
+int main(int argc, char* argv[]) {
+    int passes = (argc > 1) ? std::atoi(argv[1]) : 20000;
+
+    static uint8_t vram[0x1800];
+    srand(1);
+    for (uint8_t &byte : vram) {
+        byte = rand();
+    }
+    static Tile expected[384], actual[384];
+    decodeLoop(vram, expected, 384);
+
+    std::cout << "loop:   " << nsPerTile(decodeLoop, vram, expected, passes) << " ns/tile" << std::endl;
+
+    bool mismatch = false;
+    TileDecoder::Backend backends[] = {TileDecoder::LOOKUP, TileDecoder::SSE2, TileDecoder::AVX2};
+    for (TileDecoder::Backend backend : backends) {
+        if (!TileDecoder::select(backend)) {
+            std::cout << TileDecoder::name(backend) << ": not supported" << std::endl;
+            continue;
+        }
+        std::memset((void*)actual, 0xFF, sizeof(actual));
+        TileDecoder::decodeTiles(vram, actual, 384);
+        bool same = std::memcmp(actual, expected, sizeof(actual)) == 0;
+        mismatch |= !same;
+        std::cout << TileDecoder::name(backend) << ": " << nsPerTile(TileDecoder::decodeTiles, vram, actual, passes) << " ns/tile"
+                  << (same ? "" : " MISMATCH") << std::endl;
+    }
+    return mismatch ? 1 : 0;
+}
@@ -11,9 +11,33 @@ bool isValidROMFile(const std::string& filename) {
     return filename.size() > 3 && filename.substr(filename.size() - 3) == ".gb";
 }
 
+// <hex address>[:rwx], watching writes when no kinds are given
+bool addWatchpoint(const std::string& spec, Watchpoints& watchpoints) {
+    size_t colon = spec.find(':');
+    std::string address = spec.substr(0, colon);
+    std::string kinds = (colon == std::string::npos) ? "w" : spec.substr(colon + 1);
+    if (address.empty() || address.size() > 4 || address.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        return false;
+    }
+    uint8_t watch = 0;
+    for (char kind : kinds) {
+        switch (kind) {
+            case 'r': watch |= WATCH_READ; break;
+            case 'w': watch |= WATCH_WRITE; break;
+            case 'x': watch |= WATCH_EXECUTE; break;
+            default: return false;
+        }
+    }
+    if (watch == 0) {
+        return false;
+    }
+    watchpoints.add(std::stoul(address, nullptr, 16), watch);
+    return true;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <path_to_rom_file>" << std::endl;
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <path_to_rom_file> [--watch <address>[:rwx]]... [--break-on-hit]" << std::endl;
         return -1;
     }
 
@@ -30,18 +54,31 @@ int main(int argc, char* argv[]) {
     PPU ppu(&cpu, &mmu);
     Renderer renderer(&cpu, &ppu, &mmu);
 
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--break-on-hit") {
+            cpu.watchpoints.break_on_hit = true;
+        } else if (option != "--watch" || i + 1 == argc || !addWatchpoint(argv[++i], cpu.watchpoints)) {
+            std::cerr << "Usage: " << argv[0] << " <path_to_rom_file> [--watch <address>[:rwx]]... [--break-on-hit]" << std::endl;
+            return -1;
+        }
+    }
+
+#ifdef DEBUG_TRACE
     std::cout << "Would you like to have debug mode? Type y if so." << std::endl;
     bool debug = false;
+    Tracer tracer;
     char debug_check = getchar();
     if (debug_check == 'y') {
         debug = true;
-        mmu.set_debug();
+        mmu.set_tracer(&tracer);
         std::cout << "Debug mode activated!" << std::endl;
     } else {
         std::cout << "Debug mode not activated!" << std::endl;
     }
 
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+#endif
 
     std::cout << "Would you like to have a puase after every instruction? Type y if so. \nIf you do enable pausing, to close the application, use ctrl+c or fn+c depending on system." << std::endl;
     bool pause = false;
@@ -55,9 +92,11 @@ int main(int argc, char* argv[]) {
         std::cout << "Pausing not enabled!" << std::endl;
     }
 
+#ifdef DEBUG_TRACE
     if (debug == true) {
         cartridge.info();
     }
+#endif
 
     renderer.init("Gameboy Emulator", 640, 480);
 
@@ -70,39 +109,31 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        int cycles = 0;
-        bool check = cpu.checkInterrupts();
-        if (check) {
-            cycles = 20;
-        } else {
-            if (cpu.halted) {
-                cycles = 4;
-            } else {
-                uint8_t opcode = mmu.read_byte(cpu.PC);
-                if (debug) {
-                    std::cout << "Opcode: " << std::hex << (int)opcode << std::endl;
-                }
-
-                if (!mmu.trigger_halted) {
-                    cpu.PC++;
-                }
-                cycles = cpu.getCycles(opcode);
-                cpu.executeInstruction(opcode);
-            }
+#ifdef DEBUG_TRACE
+        if (debug && !cpu.halted) {
+            tracer.instruction(cpu);
         }
+#endif
+        int cycles = cpu.step();
 
         scheduler.increment(cycles);
-        ppu.step(cycles);
         renderer.render();
-        
+#ifdef DEBUG_TRACE
         if (debug) {
-            cpu.info();
-            mmu.info();
+            tracer.state(cpu);
+        }
+#endif
+        if (cpu.watchpoints.stopped) {
+            cpu.watchpoints.stopped = false;
+            Watchpoints::print(cpu.watchpoints.last());
+            std::cout << "Press enter to continue" << std::endl;
+            getchar();
         }
         if (pause == true){
             getchar();
         }
     }
+    cpu.watchpoints.report();
 
     return 0;
 }
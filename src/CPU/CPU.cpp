@@ -1,8 +1,15 @@
 #include "CPU.h"
+#include <algorithm>
 #include <iostream>
 
-CPU::CPU(MMU* mmu, Scheduler *scheduler) {
+CPU::CPU(MMU* mmu, Scheduler *scheduler) : block_cache(this, mmu), jit(this), watchpoints(this)
+#ifdef SAMPLING_PROFILER
+    , sampler(mmu)
+#endif
+{
     this->mmu = mmu;
+    mmu->block_cache = &block_cache;
+    mmu->watchpoints = &watchpoints;
     this->scheduler = scheduler;
     memory = mmu->memory;
     PC = 0;
@@ -10,7 +17,7 @@ CPU::CPU(MMU* mmu, Scheduler *scheduler) {
 }
 
 void CPU::info() {
-    std::cout << "A: " << (int)A << " B: " << (int)B << " C: " << (int)C << " D: " << (int)D << " E: " << (int)E << " H: " << (int)H << " L: " << (int)L << " F: " << (int)F << std::endl;
+    std::cout << "A: " << (int)A << " B: " << (int)B << " C: " << (int)C << " D: " << (int)D << " E: " << (int)E << " H: " << (int)H << " L: " << (int)L << " F: " << (int)getFlags() << std::endl;
     std::cout << "SP: " << SP << " PC: " << PC << std::endl;
 }
 
@@ -20,7 +27,7 @@ void CPU::reset() {
     C = 0x13;
     D = 0x00;
     E = 0xD8;
-    F = 0xB0;
+    setFlags(0xB0);
     H = 0x01;
     L = 0x4D;
     SP = 0xFFFE;
@@ -31,2201 +38,2147 @@ void CPU::reset() {
     setSubtractFlag(false);
 
     IME = false;
+    block_exit = false;
     mmu->rom_disabled = true;
+    mmu->map_page(0x00);
     mmu->memory[0xFF0F] = 0xE1;
+    mmu->update_pending_interrupts();
     memory[0xFF40] = 0x91; // LCDC
     memory[0xFF41] = 0x80; // STAT
-    mmu->DIV = 0xAB;
-    mmu->TIMA = 0x00;
-    mmu->TMA = 0x00;
-    mmu->TAC = 0xF8;
+    scheduler->reset_timer(0xAB, 0x00, 0x00, 0xF8); // DIV, TIMA, TMA, TAC
     std::cout << "CPU Initialized" << std::endl;
 }
 
-bool CPU::getZeroFlag() { return F & 0x80; }
-bool CPU::getSubtractFlag() { return F & 0x40; }
-bool CPU::getHalfCarryFlag() { return F & 0x20; }
-bool CPU::getCarryFlag() { return F & 0x10; }
+void CPU::setFlags(uint8_t value) {
+    flag_operation = FLAGS_NONE;
+    F = value;
+}
+// Z, N and C are cheap to derive from a pending operation without building all of F
+bool CPU::getZeroFlag() {
+    switch (flag_operation) {
+        case FLAGS_NONE: return F & 0x80;
+        case FLAGS_ADD: return (flag_result & 0xFF) == 0;
+        default: return flag_result == 0;
+    }
+}
+bool CPU::getSubtractFlag() {
+    switch (flag_operation) {
+        case FLAGS_NONE: return F & 0x40;
+        case FLAGS_SUB: case FLAGS_DEC: return true;
+        default: return false;
+    }
+}
+bool CPU::getHalfCarryFlag() { return getFlags() & 0x20; }
+bool CPU::getCarryFlag() {
+    switch (flag_operation) {
+        case FLAGS_NONE: return F & 0x10;
+        case FLAGS_ADD: return flag_result > 0xFF;
+        case FLAGS_SUB: return flag_operand1 < flag_operand2;
+        case FLAGS_INC: case FLAGS_DEC: return flag_carry;
+        default: return false;
+    }
+}
 
 void CPU::setZeroFlag(bool value) { 
-    F = (F & ~0x80) | (value << 7); 
+    F = (getFlags() & ~0x80) | (value << 7); 
 }
 void CPU::setSubtractFlag(bool value) { 
-    F = (F & ~0x40) | (value << 6); 
+    F = (getFlags() & ~0x40) | (value << 6); 
 }
 void CPU::setHalfCarryFlag(bool value) { 
-    F = (F & ~0x20) | (value << 5); 
+    F = (getFlags() & ~0x20) | (value << 5); 
 }
 void CPU::setCarryFlag(bool value) { 
-    F = (F & ~0x10) | (value << 4); 
+    F = (getFlags() & ~0x10) | (value << 4); 
 }
 
+// Any pending interrupt wakes the CPU from HALT. With IME set, the lowest pending bit
+// wins (VBlank, LCD, Timer, Serial, Joypad) and is dispatched to 0x40 + 8 * bit.
 bool CPU::checkInterrupts() {
-    if (mmu->read_byte(0xFFFF) & mmu->read_byte(0xFF0F) & 0x0F) {
-        halted = false;
+    uint8_t pending = mmu->pending_interrupts;
+    if (pending == 0) {
+        return false;
     }
+    halted = false;
     if (!IME) {
         return false;
     }
-    if (mmu->is_interrupt_enabled(mmu->VBLANK) && mmu->is_interrupt_flag_enabled(mmu->VBLANK)) {
-        updateInterrupt(mmu->VBLANK, 0x40);
-        return true;
-    }
-    if (mmu->is_interrupt_enabled(mmu->LCD) && mmu->is_interrupt_flag_enabled(mmu->LCD)) {
-        updateInterrupt(mmu->LCD, 0x48);
-        return true;
-    }
-    if (mmu->is_interrupt_enabled(mmu->TIMER) && mmu->is_interrupt_flag_enabled(mmu->TIMER)) {
-        updateInterrupt(mmu->TIMER, 0x50);
-        return true;
-    }
-    return false;
+    int source = __builtin_ctz(pending);
+    updateInterrupt(1 << source, 0x40 + source * 8);
+    return true;
 }
 
 void CPU::updateInterrupt(uint8_t interruptFlag, uint8_t pc) {
     SP -= 2;
-    mmu->write_byte(SP, (uint8_t) (pc & 0x00FF));
-    mmu->write_byte(SP, (uint8_t) ((pc & 0xFF00) >> 8));
+    mmu->push_word(SP, PC);
+    PC = pc;
     IME = false;
-    uint8_t value = mmu->read_byte(0xFF0F);
-    mmu->write_byte(0xFF0F, value | interruptFlag);
+    mmu->unset_interrupt_flag(interruptFlag);
     halted = false;
 }
 
-int CPU::getCycles(uint8_t opcode) {
-    switch (opcode) {
-        case 0x20: { // JR NZ, offset
-            if (!getZeroFlag()) { return 12; }
-            break;
-        }
-        case 0x28: { // JR Z, offset
-            if (getZeroFlag()) { return 12; }
-            break;
-        }
-        case 0x30: { // JR NC, offset
-            if (!getCarryFlag()) { return 12; }
-            break;
-        }
-        case 0x38: { // JR C, offset
-            if (getCarryFlag()) { return 12; }
-            break;
-        }
-        case 0xC0: { // RET NZ
-            if (!getZeroFlag()) { return 20; }
-            break;
-        }
-        case 0xC8: { // RET Z
-            if (getZeroFlag()) { return 20; }
-            break;
-        }
-        case 0xCB: { // CB Prefix
-            uint8_t cb = mmu->read_byte(PC++);
-            return CBinstructionCycles[cb];
-            break;
-        }
-        case 0xD0: { // RET NC
-            if (!getCarryFlag()) { return 20; }
-            break;
+// Advances the CPU by one step and returns the exact cycles it took: an interrupt
+// dispatch, one instruction, or while halted, the idle time up to the next event.
+// Opcode and operands come pre-decoded from the block cache, so PC moves past them
+// before the handler runs, and each handler returns the taken or not-taken cost
+// where it resolves its branch.
+int CPU::step() {
+#ifdef SAMPLING_PROFILER
+    uint16_t pc = PC;
+    int cycles = execute();
+    sampler.advance(cycles, pc, SP);
+    return cycles;
+#else
+    return execute();
+#endif
+}
+
+int CPU::execute() {
+    if (checkInterrupts()) {
+#ifdef SAMPLING_PROFILER
+        sampler.call(PC, SP);
+#endif
+        return 20;
+    }
+    if (halted) {
+        return scheduler->cycles_until_next_event();
+    }
+    const MicroOp &op = block_cache.fetch(PC);
+    if (op.native != nullptr) {
+        return jit.run(*op.native);
+    }
+    if (op.loop_cycles != 0) {
+        int skipped = (op.loop_kind == LOOP_BUSY_WAIT) ? skipBusyWait(&op) : runBulkLoop(&op);
+        if (skipped != 0) {
+            return skipped;
         }
-        case 0xD8: { // RET C
-            if (getCarryFlag()) { return 20; }
-            break;
+    }
+    Handler handler = op.handler;
+    operand = op.operand;
+    PC += op.length;
+#if defined(OPCODE_PROFILER) || defined(SAMPLING_PROFILER)
+    uint8_t opcode = op.opcode, base_cycles = op.cycles; // op may not survive the handler
+    uint16_t sp = SP;
+    int cycles = (this->*handler)();
+#ifdef OPCODE_PROFILER
+    profiler.record(opcode, operand, cycles, base_cycles);
+#endif
+#ifdef SAMPLING_PROFILER
+    sampler.track(opcode, sp, SP, PC);
+#endif
+    (void)base_cycles; (void)sp;
+    return cycles;
+#else
+    return (this->*handler)();
+#endif
+}
+
+// A busy-wait loop only reads LY or STAT, which cannot change before the next timer
+// or PPU event, so every iteration until then reads the same value and loops again.
+// Returns the cycles of those whole iterations, leaving PC at the loop start for the
+// next real iteration to set A and F. loop points at the loop's three decoded ops.
+int CPU::skipBusyWait(const MicroOp *loop) {
+    if (scheduler->ppu == nullptr) {
+        return 0;
+    }
+    if (watchpoints.watched(0xFF00 | loop[0].operand, WATCH_READ)) {
+        return 0; // Every read has to be seen
+    }
+#ifdef DEBUG_TRACE
+    if (mmu->tracer != nullptr) {
+        return 0; // Every iteration is logged
+    }
+#endif
+    uint8_t value = mmu->read_byte(0xFF00 | loop[0].operand);
+    const MicroOp &test = loop[1];
+    bool zero;
+    if (test.opcode == 0xFE) { // CP n8
+        zero = value == (uint8_t)test.operand;
+    } else if (test.opcode == 0xE6) { // AND n8
+        zero = (value & test.operand) == 0;
+    } else { // BIT b, A
+        zero = (value & (1 << ((test.operand >> 3) & 0x07))) == 0;
+    }
+    if (zero != (loop[2].opcode == 0x28)) {
+        return 0; // This iteration exits the loop
+    }
+
+    int iterations = (scheduler->cycles_until_next_event() - 4) / loop[0].loop_cycles;
+    int cycles = iterations * loop[0].loop_cycles;
+    busy_wait_cycles += cycles;
+    return cycles;
+}
+
+// Copy and fill loops only touch VRAM, work RAM and registers, so nothing they do
+// is visible to the timer or PPU and nothing those do is visible to them. Every
+// iteration that branches back and ends before the next timer or PPU event runs at
+// once through the MMU's bulk helpers. Registers and flags end up as the last of
+// those iterations leaves them; the final, falling-through iteration is left to the
+// interpreter. Returns 0 to fall back when the pointers leave plain memory.
+int CPU::runBulkLoop(const MicroOp *loop) {
+    if (scheduler->ppu == nullptr) {
+        return 0;
+    }
+    bool fill = loop[0].loop_kind == LOOP_FILL;
+    const MicroOp &counter = loop[fill ? (loop[0].opcode == 0x22 ? 1 : 2) : 3];
+    uint8_t *counter_register = (counter.opcode == 0x05) ? &B : &C;
+    int iterations = (counter.opcode == 0x0B) ? (uint16_t)(BC - 1) : (uint8_t)(*counter_register - 1);
+    iterations = std::min(iterations, scheduler->cycles_until_next_event() / loop[0].loop_cycles);
+
+    uint16_t &destination = (fill || loop[0].opcode == 0x1A) ? HL : DE;
+    uint16_t &source = (loop[0].opcode == 0x1A) ? DE : HL;
+    iterations = mmu->plain_span(destination, iterations);
+    if (!fill && source < 0xFE00) {
+        iterations = std::min(iterations, 0xFE00 - source);
+    } else if (!fill) {
+        iterations = 0;
+    }
+    if (iterations <= 0) {
+        return 0;
+    }
+
+    if (fill) {
+        if (loop[0].opcode == 0xAF) { // XOR A
+            A = 0;
+            orFlags(A);
+        } else if (loop[0].opcode == 0x3E) { // LD A, n8
+            A = loop[0].operand;
         }
-        case 0xC4: { // CALL NZ, addr
-            if (!getZeroFlag()) { return 24; }
-            break;
+        mmu->fill(destination, A, iterations);
+        HL += iterations;
+    } else {
+        mmu->copy(destination, source, iterations);
+        A = mmu->memory[(uint16_t)(destination + iterations - 1)];
+        HL += iterations;
+        DE += iterations;
+    }
+    if (counter.opcode == 0x0B) { // DEC BC; LD A, B; OR C
+        BC -= iterations;
+        A = B | C;
+        orFlags(A);
+    } else { // DEC B or DEC C
+        *counter_register -= iterations;
+        decrementFlags(*counter_register);
+    }
+
+    int cycles = iterations * loop[0].loop_cycles;
+    bulk_loop_cycles += cycles;
+    return cycles;
+}
+MicroOp CPU::decode(uint16_t address) {
+    MicroOp op;
+    op.address = address;
+    op.opcode = mmu->peek(address);
+    op.handler = opcodes[op.opcode];
+    op.length = OPCODES[op.opcode].length;
+    op.operand = 0;
+    if (op.length == 2) {
+        op.operand = mmu->peek(address + 1);
+    } else if (op.length == 3) {
+        op.operand = mmu->fetch_imm16(address);
+    }
+    op.cycles = opcodeInfo(op.opcode, op.operand).cycles;
+    return op;
+}
+
+int CPU::executeCBInstruction(uint8_t cb_opcode) {
+    return (this->*CBopcodes[cb_opcode])();
+}
+
+// Opcode handlers. Each one executes a single instruction and returns the cycles it took,
+// so conditional branches report the taken or not-taken cost they actually resolved.
+// Immediates are read from operand and PC already points at the next instruction.
+// Opcodes without a specialisation fall back to the invalid opcode handler.
+template <uint8_t opcode>
+int CPU::op() {
+    std::cout << "Invalid opcode: " << std::hex << (int)opcode << std::endl;
+    return 4;
+}
+
+template <>
+int CPU::op<0x00>() { // NOP
+    return 4;
+}
+template <>
+int CPU::op<0x01>() { // LD BC, n16
+    BC = operand;
+    return 12;
+}
+template <>
+int CPU::op<0x02>() { // LD (BC), A
+    mmu->write_byte(BC, A);
+    return 8;
+}
+template <>
+int CPU::op<0x03>() { // INC BC
+    BC++;
+    return 8;
+}
+template <>
+int CPU::op<0x04>() { // INC B
+    B++;
+    incrementFlags(B);
+    return 4;
+}
+template <>
+int CPU::op<0x05>() { // DEC B
+    B--;
+    decrementFlags(B);
+    return 4;
+}
+template <>
+int CPU::op<0x06>() { // LD B, n8
+    B = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x07>() { // RLCA (Rotate Left Circular A)
+    RLC(A);
+    setZeroFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x08>() { // LD (a16), SP
+    uint16_t address = operand;
+    mmu->write_word(address, SP);
+    return 20;
+}
+template <>
+int CPU::op<0x09>() { // ADD HL, BC
+    uint32_t result = HL + BC;
+    setSubtractFlag(false);
+    setHalfCarryFlag(((HL & 0x0FFF) + (BC & 0x0FFF)) > 0x0FFF);
+    setCarryFlag(result > 0xFFFF);
+    HL = result;
+    return 8;
+}
+template <>
+int CPU::op<0x0A>() { // LD A, [BC]
+    A = mmu->read_byte(BC);
+    return 8;
+}
+template <>
+int CPU::op<0x0B>() { // DEC BC
+    BC--;
+    return 8;
+}
+template <>
+int CPU::op<0x0C>() { // INC C
+    C++;
+    incrementFlags(C);
+    return 4;
+}
+template <>
+int CPU::op<0x0D>() { // DEC C
+    C--;
+    decrementFlags(C);
+    return 4;
+}
+template <>
+int CPU::op<0x0E>() { // LD C, d8
+    C = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x0F>() { // RRCA (Rotate Right Circular A)
+    RRC(A);
+    setZeroFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x10>() { // STOP n8
+    return 4;
+}
+template <>
+int CPU::op<0x11>() { // LD DE, n16
+    DE = operand;
+    return 12;
+}
+template <>
+int CPU::op<0x12>() { // LD (DE), A
+    mmu->write_byte(DE, A);
+    return 8;
+}
+template <>
+int CPU::op<0x13>() { // INC DE
+    DE++;
+    return 8;
+}
+template <>
+int CPU::op<0x14>() { // INC D
+    D++;
+    incrementFlags(D);
+    return 4;
+}
+template <>
+int CPU::op<0x15>() { // DEC D
+    D--;
+    decrementFlags(D);
+    return 4;
+}
+template <>
+int CPU::op<0x16>() { // LD D, n8
+    D = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x17>() { // RLA (Rotate Left A)
+    RL(A);
+    setZeroFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x18>() { // JR e8
+    int8_t offset = operand;
+    PC += offset;
+    return 12;
+}
+template <>
+int CPU::op<0x19>() { // ADD HL, DE
+    uint32_t result = HL + DE;
+    setSubtractFlag(false);
+    setHalfCarryFlag(((HL & 0x0FFF) + (DE & 0x0FFF)) > 0x0FFF);
+    setCarryFlag(result > 0xFFFF);
+    HL = result;
+    return 8;
+}
+template <>
+int CPU::op<0x1A>() { // LD A, [DE]
+    A = mmu->read_byte(DE);
+    return 8;
+}
+template <>
+int CPU::op<0x1B>() { // DEC DE
+    DE--;
+    return 8;
+}
+template <>
+int CPU::op<0x1C>() { // INC E
+    E++;
+    incrementFlags(E);
+    return 4;
+}
+template <>
+int CPU::op<0x1D>() { // DEC E
+    E--;
+    decrementFlags(E);
+    return 4;
+}
+template <>
+int CPU::op<0x1E>() { // LD E, n8
+    E = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x1F>() { // RRA
+    RR(A);
+    setZeroFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x20>() { // JR NZ, e8
+    int8_t offset = operand;
+    if (!getZeroFlag()) {
+        PC += offset;
+        return 12;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0x21>() { // LD HL, n16
+    HL = operand;
+    return 12;
+}
+template <>
+int CPU::op<0x22>() { // LD [HL+], A
+    mmu->write_byte(HL, A);
+    HL++;
+    return 8;
+}
+template <>
+int CPU::op<0x23>() { // INC HL
+    HL++;
+    return 8;
+}
+template <>
+int CPU::op<0x24>() { // INC H
+    H++;
+    incrementFlags(H);
+    return 4;
+}
+template <>
+int CPU::op<0x25>() { // DEC H
+    H--;
+    decrementFlags(H);
+    return 4;
+}
+template <>
+int CPU::op<0x26>() { // LD H, n8
+    H = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x27>() { // DAA
+    uint16_t correction = 0;
+    if (!getSubtractFlag()) {
+        if (getHalfCarryFlag() || (A & 0x0F) > 0x09) {
+            correction += 0x06;
         }
-        case 0xCC: { // CALL Z, addr
-            if (getZeroFlag()) { return 24; }
-            break;
+        if (getCarryFlag() || A > 0x99) {
+            correction += 0x60;
+            setCarryFlag(true);
         }
-        case 0xD4: { // CALL NC, addr
-            if (!getCarryFlag()) { return 24; }
-            break;
+    } else {
+        if (getHalfCarryFlag()) {
+            correction -= 0x06;
         }
-        case 0xDC: { // CALL C, addr
-            if (getCarryFlag()) { return 24; }
-            break;
+        if (getCarryFlag()) {
+            correction -= 0x60;
         }
     }
-    return instructionCycles[opcode];
+    A += correction;
+    setZeroFlag(A == 0);
+    setHalfCarryFlag(false);
+    return 4;
 }
-
-void CPU::executeInstruction(uint8_t opcode) {
-    //info();
-    // std::cout << "Opcode: " << std::hex << (int)opcode << "\n" << "PC: " << std::hex << (int)PC << std::endl;
-    switch (opcode) {
-        case 0x00: { // NOP
-            break;
-        } case 0x01: { // LD BC, n16
-            uint16_t BC = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            B = (uint8_t) (BC >> 8 & 0xFF);
-            C = (uint8_t) (BC & 0xFF);
-            PC += 2;
-            break;
-        } case 0x02: { // LD (BC), A
-            uint16_t BC = (B << 8) | C;
-            mmu->write_byte(BC, A);
-            break;
-        } case 0x03: { // INC BC
-            uint16_t BC = (B << 8) | C;
-            BC++;
-            B = (uint8_t) (BC >> 8 & 0xFF);
-            C = (uint8_t) (BC & 0xFF);
-            break;
-        } case 0x04: { // INC B
-            B++;
-            incrementFlags(B);
-            break;
-        }  case 0x05: { // DEC B
-            B--;
-            decrementFlags(B);
-            break;
-        } case 0x06: { // LD B, n8
-            B = mmu->read_byte(PC++);
-            break;
-        } case 0x07: { // RLCA (Rotate Left Circular A)
-            RLC(A);
-            setZeroFlag(false);
-            break;
-        } case 0x08: { // LD (a16), SP
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            mmu->write_byte(address, (uint8_t)(SP & 0x00FF));
-            mmu->write_byte(address + 1, (uint8_t)((SP & 0xFF00) >> 8));
-            PC += 2;
-            break;
-        } case 0x09: { // ADD HL, BC
-            uint16_t BC = (B << 8) | C;
-            uint16_t HL = (H << 8) | L;
-            uint32_t result = (HL + BC);
-            HL = result & 0xFFFF;
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            setZeroFlag(HL == 0);
-            setSubtractFlag(false);
-            setHalfCarryFlag(((HL & 0xFFF) + (BC & 0xFFF)) > 0xFFF);
-            break;
-        } case 0x0A: { // LD A, [BC]
-            uint16_t address = (B << 8) | C;
-            A = mmu->read_byte(address);
-            break;
-        } case 0x0B: { // DEC BC
-            uint16_t BC = (B << 8) | C;
-            BC--; 
-            B = BC >> 8 & 0xFF;  
-            C = BC & 0xFF;  
-            break;
-        } case 0x0C: { // INC C
-            C++;
-            incrementFlags(C);
-            break;
-        } case 0x0D: { // DEC C
-            C--;
-            decrementFlags(C);
-            break;
-        } case 0x0E: { // LD C, d8
-            C = mmu->read_byte(PC++);
-            break;
-        } case 0x0F: { // RRCA (Rotate Right Circular A)
-            RRC(A);
-            setZeroFlag(false);
-            break;
-        } case 0x10: { // STOP n8
-            break;
-        } case 0x11: { // LD DE, n16
-            uint16_t DE = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            D = (DE >> 8) & 0xFF;
-            E = DE & 0xFF;
-            PC += 2;
-            break;
-        } case 0x12: { // LD (DE), A
-            uint16_t DE = (D << 8) | E;
-            mmu->write_byte(DE, A);
-            break;
-        } case 0x13: { // INC DE
-            u_int16_t DE = (D << 8) | E;
-            DE++;
-            D = (DE >> 8) & 0xFF;
-            E = DE & 0xFF;
-            break;
-        } case 0x14: { // INC D
-            D++;
-            incrementFlags(D);
-            break;
-        } case 0x15: { // DEC D
-            D--;
-            decrementFlags(D);
-            break;
-        } case 0x16: { // LD D, n8
-            D = mmu->read_byte(PC++);
-            break;
-        } case 0x17: { // RLA (Rotate Left A)
-            RL(A);
-            setZeroFlag(false);
-            break;
-        } case 0x18: { // JR e8
-            uint8_t offset = mmu->read_byte(PC + 1);
-            PC += 2;
-            PC += int8_t(offset);
-            break;
-        } case 0x19: { // ADD HL, DE
-            uint16_t HL = (H << 8) | L;
-            uint16_t DE = (D << 8) | E;
-            uint32_t result = HL + DE;
-            H = (result >> 8) & 0xFF;
-            L = result & 0xFF;
-            setSubtractFlag(false);
-            setHalfCarryFlag(((HL & 0x0FFF) + (DE & 0x0FFF)) > 0x0FFF);
-            setCarryFlag(result > 0xFFFF);
-            break;
-        } case 0x1A: { // LD A, [DE]
-            uint16_t DE = (D << 8) | E;
-            A = mmu->read_byte(DE);
-            break;
-        } case 0x1B: { // DEC DE
-            uint16_t DE = (D << 8) | E;
-            DE--;
-            D = (DE >> 8) & 0xFF;
-            E = DE & 0xFF;
-            break;
-        } case 0x1C: { // INC E
-            E++;
-            incrementFlags(E);
-            break;
-        } case 0x1D: { // DEC E
-            E--;
-            decrementFlags(E);
-            break;
-        } case 0x1E: { // LD E, n8
-            E = mmu->read_byte(PC++);
-            break;
-        } case 0x1F: { // RRA
-            RR(A);
-            setZeroFlag(false);
-            break;
-        } case 0x20: { // JR NZ, e8
-            uint8_t offset = mmu->read_byte(PC + 1);
-            if (getZeroFlag()) {
-                PC += 2;
-                PC += int8_t(offset);
-            } else {
-                PC += 2;
-            }
-            break;
-        } case 0x21: { // LD HL, n16
-            uint16_t HL = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            PC += 2;
-            break;
-        } case 0x22: { // LD [HL+], A
-            uint16_t HL = (H << 8) | L;
-            mmu->write_byte(HL, A);
-            HL++;
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x23: { // INC HL
-            uint16_t HL = (H << 8) | L;
-            HL++;
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x24: { // INC H
-            H++;
-            incrementFlags(H);
-            break;
-        } case 0x25: { // DEC H
-            H--;
-            decrementFlags(H);
-            break;
-        } case 0x26: { // LD H, n8
-            H = mmu->read_byte(PC++);
-            break;
-        } case 0x27: { // DAA
-            uint16_t correction = 0;
-            if (!getSubtractFlag()) { 
-                if (getHalfCarryFlag() || (A & 0x0F) > 0x09) {
-                    correction += 0x06; 
-                }
-                if (getCarryFlag() || A > 0x99) {
-                    correction += 0x60;
-                    setCarryFlag(true);
-                }
-            } else {
-                if (getHalfCarryFlag()) {
-                    correction -= 0x06;
-                }
-                if (getCarryFlag()) {
-                    correction -= 0x60;
-                }
-            }
-            A += correction;
-            setZeroFlag(A == 0);
-            setHalfCarryFlag(false); 
-            break;
-        } case 0x28: { // JR Z, e8
-            uint8_t offset = mmu->read_byte(PC + 1);
-            if (getZeroFlag()) {
-                PC += 2;
-                PC += int8_t(offset);
-            } else {
-                PC += 2;
-            }
-            break;
-        } case 0x29: { // ADD HL, HL
-            uint16_t HL = (H << 8) | L;
-            uint32_t result = HL + HL;
-            H = (result >> 8) & 0xFF;
-            L = result & 0xFF;
-            break;
-        } case 0x2A: { // LD A, [HL+]
-            uint16_t HL = (H << 8) | L;
-
-            A = mmu->read_byte(HL++);
-            std::cout << "Byte read!";
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x2B: { // DEC HL
-            uint16_t HL = (H << 8) | L;
-            HL--;
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x2C: { // INC L
-            L++;
-            incrementFlags(L);
-            break;
-        } case 0x2D: { // DEC L
-            L--;
-            decrementFlags(L);
-            break;
-        } case 0x2E: { // LD L, n8
-            L = mmu->read_byte(PC++);
-            break;
-        } case 0x2F: { // CPL
-            A = ~A;
-            setSubtractFlag(true);
-            setHalfCarryFlag(true);
-            break;
-        } case 0x30: { // JR NC, e8
-            uint8_t offset = mmu->read_byte(PC + 1);
-            if (!getCarryFlag()) {
-                PC += 2;
-                PC += int8_t(offset);
-            } else {
-                PC += 2;
-            }
-            break;
-        } case 0x31: { // LD SP, n16
-            SP = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            break;
-        } case 0x32: { // LD [HL-], A
-            uint16_t HL = (H << 8) | L;
-            mmu->write_byte(HL, A);
-            HL--;
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x33: {// INC SP
-            SP++;
-            break;
-        } case 0x34: { // INC [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            uint8_t result = value + 1;
-            mmu->write_byte(HL, result);
-            setZeroFlag(result == 0);
-            setSubtractFlag(false);
-            setHalfCarryFlag((result & 0x0F) == 0x0F);
-            break;
-        } case 0x35: { // DEC [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            uint8_t result = value - 1;
-            mmu->write_byte(HL, result);
-            setZeroFlag(result == 0);
-            setSubtractFlag(false);
-            setHalfCarryFlag((result & 0x0F) == 0x0F);
-            break;
-        } case 0x36: { // LD [HL], n8
-            uint16_t HL = (H << 8) | L;
-            mmu->write_byte(HL, mmu->read_byte(PC++));
-            break;
-        } case 0x37: { // SCF
-            setCarryFlag(true);
-            setSubtractFlag(false);
-            setHalfCarryFlag(false);
-            break;
-        } case 0x38: { // JR C, e8
-            uint8_t offset = mmu->read_byte(PC + 1);
-            if (getCarryFlag()) {
-                PC += 2;
-                PC += int8_t(offset);
-            } else {
-                PC += 2;
-            }
-            break;
-        } case 0x39: { // ADD HL, SP
-            uint16_t HL = (H << 8) | L;
-            uint32_t result = HL + SP;
-            H = (result >> 8) & 0xFF;
-            L = result & 0xFF;
-            setSubtractFlag(false);
-            setHalfCarryFlag(((HL & 0x0F) + (SP & 0x0F)) > 0x0F);
-            setCarryFlag(HL > 0xFFFF);
-            break;
-        } case 0x3A: { // LD A, [HL-]
-            uint16_t HL = (H << 8) | L;
-            A = mmu->read_byte(HL--);
-            H = (HL >> 8) & 0xFF;
-            L = HL & 0xFF;
-            break;
-        } case 0x3B: {// DEC SP
-            SP--;
-            break;
-        } case 0x3C: { // INC A
-            A++;
-            incrementFlags(A);
-            break;
-        } case 0x3D: { // DEC A
-            A--;
-            decrementFlags(A);
-            break;
-        } case 0x3E: { // LD A, n8
-            A = mmu->read_byte(PC++);
-            break;
-        } case 0x3F: { // CCF
-            setCarryFlag(!getCarryFlag());
-            setSubtractFlag(false);
-            setHalfCarryFlag(false);
-            break;
-        } case 0x40: { // LD B, B
-            B = B;
-            break;
-        } case 0x41: { // LD B, C
-            B = C;
-            break;
-        } case 0x42: { // LD B, D
-            B = D;
-            break;
-        } case 0x43: {// LD B, E
-            B = E;
-            break;
-        } case 0x44: {// LD B, H
-            B = H;
-            break;
-        } case 0x45: {// LD B, L
-            B = L;
-            break;
-        } case 0x46: { // LD B, [HL]
-            B = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x47: { // LD B, A
-            B = A;
-            break;
-        } case 0x48: { // LD C, B
-            C = B;
-            break;
-        } case 0x49: { // LD C, C
-            C = C;
-            break;
-        } case 0x4A: { // LD C, D
-            C = D;
-            break;
-        } case 0x4B: { // LD C, E
-            C = E;
-            break;
-        } case 0x4C: { // LD C, H
-            C = H;
-            break;
-        } case 0x4D: { // LD C, L
-            C = L;
-            break;
-        } case 0x4E: { // LD C, [HL]
-            C = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x4F: { // LD C, A
-            C = A;
-            break;
-        } case 0x50: { // LD D, B
-            D = B;
-            break;
-        } case 0x51: { // LD D, C
-            D = C;
-            break;
-        } case 0x52: { // LD D, D
-            D = D;
-            break;
-        } case 0x53: { // LD D, E
-            D = E;
-            break;
-        } case 0x54: { // LD D, H
-            D = H;
-            break;
-        } case 0x55: { // LD D, L
-            D = L;
-            break;
-        } case 0x56: { // LD D, [HL]
-            D = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x57: { // LD D, A
-            D = A;
-            break;
-        } case 0x58: { // LD E, B
-            E = B;
-            break;
-        } case 0x59: { // LD E, C
-            E = C;
-            break;
-        } case 0x5A: { // LD E, D
-            E = D;
-            break;
-        } case 0x5B: { // LD E, E
-            E = E;
-            break;
-        } case 0x5C: { // LD E, H
-            E = H;
-            break;
-        } case 0x5D: { // LD E, L
-            E = L;
-            break;
-        } case 0x5E: { // LD E, [HL]
-            E = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x5F: { // LD E, A
-            E = A;
-            break;
-        } case 0x60: { // LD H, B
-            H = B;
-            break;
-        } case 0x61: { // LD H, C
-            H = C;
-            break;
-        } case 0x62: { // LD H, D
-            H = D;
-            break;
-        } case 0x63: { // LD H, E
-            H = E;
-            break;
-        } case 0x64: { // LD H, H
-            H = H;
-            break;
-        } case 0x65: { // LD H, L
-            H = L;
-            break;
-        } case 0x66: { // LD H, [HL]
-            H = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x67: { // LD H, A
-            H = A;
-            break;
-        } case 0x68: { // LD L, B
-            L = B;
-            break;
-        } case 0x69: { // LD L, C
-            L = C;
-            break;
-        } case 0x6A: { // LD L, D
-            L = D;
-            break;
-        } case 0x6B: { // LD L, E
-            L = E;
-            break;
-        } case 0x6C: { // LD L, H
-            L = H;
-            break;
-        } case 0x6D: { // LD L, L
-            L = L;
-            break;
-        } case 0x6E: { // LD L, [HL]
-            L = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x6F: { // LD L, A
-            L = A;
-            break;
-        } case 0x70: { // LD [HL], B
-            mmu->write_byte((H << 8) | L, B);
-            break;
-        } case 0x71: { // LD [HL], C
-            mmu->write_byte((H << 8) | L, C);
-            break;
-        } case 0x72: { // LD [HL], D
-            mmu->write_byte((H << 8) | L, D);
-            break;
-        } case 0x73: { // LD [HL], E
-            mmu->write_byte((H << 8) | L, E);
-            break;
-        } case 0x74: { // LD [HL], H
-            mmu->write_byte((H << 8) | L, H);
-            break;
-        } case 0x75: { // LD [HL], L
-            mmu->write_byte((H << 8) | L, L);
-            break;
-        } case 0x76: { // HALT
-            if (!IME && (mmu->read_byte(0xFFFF) & mmu->read_byte(0xFF0F) & 0x1F)) {
-                IME = true;
-                halted = false;
-                break;
-            }
-            halted = true;
-            break;
-        } case 0x77: { // LD [HL], A
-            mmu->write_byte((H << 8) | L, A);
-            break;
-        } case 0x78: { // LD A, B
-            A = B;
-            break;
-        } case 0x79: { // LD A, C
-            A = C;
-            break;
-        } case 0x7A: { // LD A, D
-            A = D;
-            break;
-        } case 0x7B: { // LD A, E
-            A = E;
-            break;
-        } case 0x7C: { // LD A, H
-            A = H;
-            break;
-        } case 0x7D: { // LD A, L
-            A = L;
-            break;
-        } case 0x7E: { // LD A, [HL]
-            A = mmu->read_byte((H << 8) | L);
-            break;
-        } case 0x7F: { // LD A, A
-            A = A;
-            break;
-        } case 0x80: { // ADD A, B
-            uint16_t result = A + B;
-            additionFlags(A, B, result);
-            A = result & 0xFF;
-            break;
-        } case 0x81: { // ADD A, C
-            uint16_t result = A + C;
-            additionFlags(A, C, result);
-            A = result & 0xFF;
-            break;
-        } case 0x82: { // ADD A, D
-            uint16_t result = A + D;
-            additionFlags(A, D, result);
-            A = result & 0xFF;
-            break;
-        } case 0x83: { // ADD A, E
-            uint16_t result = A + E;
-            additionFlags(A, E, result);
-            A = result & 0xFF;
-            break;
-        } case 0x84: { // ADD A, H
-            uint16_t result = A + H;
-            additionFlags(A, H, result);
-            A = result & 0xFF;
-            break;
-        } case 0x85: { // ADD A, L
-            uint16_t result = A + L;
-            additionFlags(A, L, result);
-            A = result & 0xFF;
-            break;
-        } case 0x86: { // ADD A, [HL]
-            uint8_t value = mmu->read_byte((H << 8) | L);
-            uint16_t result = A + value;
-            additionFlags(A, value, result);
-            A = result & 0xFF;
-            break;
-        } case 0x87: { // ADD A, A
-            uint16_t result = A + A;
-            additionFlags(A, A, result);
-            A = result & 0xFF;
-            break;
-        } case 0x88: { // ADC A, B
-            uint16_t result = A + B + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, B + getCarryFlag(), result);
-            A = result & 0xFF;   
-            break;
-        } case 0x89: { // ADC A, C
-            uint16_t result = A + C + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, C + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8A: { // ADC A, D
-            uint16_t result = A + D + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, D + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8B: { // ADC A, E
-            uint16_t result = A + E + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, E + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8C: { // ADC A, H
-            uint16_t result = A + H + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, H + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8D: { // ADC A, L
-            uint16_t result = A + L + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, L + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8E: { // ADC A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            uint16_t result = A + value + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, value + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x8F: { // ADC A, A
-            uint16_t result = A + A + (getCarryFlag() ? 1 : 0);
-            additionFlags(A, A + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x90: { // SUB A, B
-            uint16_t result = A - B;
-            subtractionFlags(A, B, result);
-            A = result & 0xFF;
-            break;
-        } case 0x91: { // SUB A, C
-            uint16_t result = A - C;
-            subtractionFlags(A, C, result);
-            A = result & 0xFF;
-            break;
-        } case 0x92: { // SUB A, D
-            uint16_t result = A - D;
-            subtractionFlags(A, D, result);
-            A = result & 0xFF;
-            break;
-        } case 0x93: { // SUB A, E
-            uint16_t result = A - E;
-            subtractionFlags(A, E, result);
-            A = result & 0xFF;
-            break;
-        } case 0x94: { // SUB A, H
-            uint16_t result = A - H;
-            subtractionFlags(A, H, result);
-            A = result & 0xFF;
-            break;
-        } case 0x95: { // SUB A, L
-            uint16_t result = A - L;
-            subtractionFlags(A, L, result);
-            A = result & 0xFF;
-            break;
-        } case 0x96: { // SUB A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            uint16_t result = A - value;
-            subtractionFlags(A, value, result);
-            A = result & 0xFF;
-            break;
-        } case 0x97: { // SUB A, A
-            uint16_t result = A - A;
-            subtractionFlags(A, L, result);
-            A = result & 0xFF;
-            break;
-        } case 0x98: { // SBC A, B
-            uint16_t result = A - B - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, B + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x99: { // SBC A, C
-            uint16_t result = A - C - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, C + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x9A: { // SBC A, D
-            uint16_t result = A - D - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, D + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x9B: { // SBC A, E
-            uint16_t result = A - E - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, E + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x9C: { // SBC A, H
-            uint16_t result = A - H - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, H + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x9D: { // SBC A, L
-            uint16_t result = A - L - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, L + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0x9E: { // SBC A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            uint16_t result = A - value - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, value, result);
-            A = result & 0xFF;
-            break;
-        } case 0x9F: { // SBC A, A
-            uint16_t result = A - A - (getCarryFlag() ? 1 : 0);
-            subtractionFlags(A, A + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0xA0: { // AND A, B
-            A &= B;
-            andFlags(A);
-            break;
-        } case 0xA1: { // AND A, C
-            A &= C;
-            andFlags(A);
-            break;
-        } case 0xA2: { // AND A, D
-            A &= D;
-            andFlags(A);
-            break;
-        } case 0xA3: { // AND A, E
-            A &= E;
-            andFlags(A);
-            break;
-        } case 0xA4: { // AND A, H
-            A &= H;
-            andFlags(A);
-            break;
-        } case 0xA5: { // AND A, L
-            A &= L;
-            andFlags(A);
-            break;
-        } case 0xA6: { // AND A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            A &= value;
-            andFlags(A);
-            break;
-        } case 0xA7: { // AND A, A
-            A &= A;
-            andFlags(A);
-            break;
-        } case 0xA8: { // XOR A, B
-            A ^= B;
-            orFlags(A);
-            break;
-        } case 0xA9: { // XOR A, C
-            A ^= C;
-            orFlags(A);
-            break;
-        } case 0xAA: { // XOR A, D
-            A ^= D;
-            orFlags(A);
-            break;
-        } case 0xAB: { // XOR A, E
-            A ^= E;
-            orFlags(A);
-            break;
-        } case 0xAC: { // XOR A, H
-            A ^= H;
-            orFlags(A);
-            break;
-        } case 0xAD: { // XOR A, L
-            A ^= L;
-            orFlags(A);
-            break;
-        } case 0xAE: { // XOR A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            A ^= value;
-            orFlags(A);
-            break;
-        } case 0xAF: { // XOR A, A
-            A ^= A;
-            orFlags(A);
-            break;
-        } case 0xB0: { // OR A, B
-            A |= B;
-            orFlags(A);
-            break;
-        } case 0xB1: { // OR A, C
-            A |= C;
-            orFlags(A);
-            break;
-        } case 0xB2: { // OR A, D
-            A |= D;
-            orFlags(A);
-            break;
-        } case 0xB3: { // OR A, E
-            A |= E;
-            orFlags(A);
-            break;
-        } case 0xB4: { // OR A, H
-            A |= H;
-            orFlags(A);
-            break;
-        } case 0xB5: { // OR A, L
-            A |= L;
-            orFlags(A);
-            break;
-        } case 0xB6: { // OR A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            A |= value;
-            orFlags(A);
-            break;
-        } case 0xB7: { // OR A, A
-            A |= A;
-            orFlags(A);
-            break;
-        } case 0xB8: { // CP A, B
-            subtractionFlags(A, B, A - B);
-            break;
-        } case 0xB9: { // CP A, C
-            subtractionFlags(A, C, A - C);
-            break;
-        } case 0xBA: { // CP A, D
-            subtractionFlags(A, D, A - D);
-            break;
-        } case 0xBB: { // CP A, E
-            subtractionFlags(A, E, A - E);
-            break;
-        } case 0xBC: { // CP A, H
-            subtractionFlags(A, H, A - H);
-            break;
-        } case 0xBD: { // CP A, L
-            subtractionFlags(A, L, A - L);
-            break;
-        } case 0xBE: { // CP A, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            subtractionFlags(A, value, A - value);
-            break;
-        } case 0xBF: { // CP A, A
-            subtractionFlags(A, A, A - A);
-            break;
-        } case 0xC0: { // RET NZ
-            if (!getZeroFlag()) {
-                PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            }
-            break;
-        } case 0xC1: { // POP BC
-            uint16_t BC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            SP += 2;
-
-            B = BC >> 8;
-            C = BC & 0xFF;
-            break;
-        } case 0xC2: { // JP NZ, a16
-            if (!getZeroFlag()) {
-                PC = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-                break;
-            }
-            PC++;
-            break;
-        } case 0xC3: { // JP a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC = address;
-            break;
-        } case 0xC4: { // CALL NZ, a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            if (!getZeroFlag()) {
-                SP -= 2;
-                mmu->write_byte(SP, (uint8_t)(PC & 0x00ff));
-                mmu->write_byte(SP + 1, (uint8_t)((PC & 0xff00) >> 8));
-                PC = address;
-            } 
-            break;
-        } case 0xC5: { // PUSH BC
-            uint16_t BC = (B << 8) | C;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(BC & 0x00ff));
-            mmu->write_byte(SP + 1, (uint8_t)((BC & 0xff00) >> 8));
-            break;
-        } case 0xC6: { // ADD A, n8
-            uint8_t value = mmu->read_byte(PC++);
-            uint16_t result = A + value;
-            additionFlags(A, value, result);
-            A = result & 0xFF;
-            break;
-        } case 0xC7: { // RST $00
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF)); // HIGH byte
-            PC = 0x0000;
-            break;
-        } case 0xC8: { // RET Z
-            if (getZeroFlag()) {
-                PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            }
-            break;
-        } case 0xC9: { // RET
-            PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            break;
-        } case 0xCA: { // JP Z, a16
-            if (getZeroFlag()) {
-                PC = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-                break;
-            }
-            PC += 2;
-            break;
-        } case 0xCB: { // CB PREFIX
-            uint8_t cb_opcode = mmu->read_byte(PC++);
-            executeCBInstruction(cb_opcode);
-            break;
-        } case 0xCC: { // CALL Z, a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            if (getZeroFlag()) {
-                SP -= 2;
-                mmu->write_byte(SP, (uint8_t)(PC & 0x00ff));
-                mmu->write_byte(SP + 1, (uint8_t)((PC & 0xff00) >> 8));
-                PC = address;
-            } 
-            break;
-        } case 0xCD: { // CALL a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(PC & 0x00ff));
-            mmu->write_byte(SP + 1, (uint8_t)((PC & 0xff00) >> 8));
-            PC = address;
-            break;
-        } case 0xCE: { // ADC A, n8
-            uint8_t value = mmu->read_byte(PC++);            
-            uint16_t result = A + value + (getCarryFlag() ? 1 : 0);            
-            additionFlags(A, value + (getCarryFlag() ? 1 : 0), result);
-            A = result & 0xFF;
-            break;
-        } case 0xCF: { // RST $08
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF)); // HIGH byte
-            PC = 0x0008;
-            break;
-        } case 0xD0: { // RET NC
-            if (!getCarryFlag()) {
-                PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            }
-            break;
-        } case 0xD1: { // POP DE
-            uint16_t DE = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            SP += 2;
-
-            D = DE >> 8;
-            E = DE & 0xFF;
-            break;
-        } case 0xD2: { // JP NC, a16
-            if (!getCarryFlag()) {
-                PC = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-                break;
-            }
-            PC += 2;
-            break;
-        } case 0xD4: { // CALL NC, a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            if (!getCarryFlag()) { 
-                SP -= 2;
-                mmu->write_byte(SP, (uint8_t)(PC & 0x00ff));
-                mmu->write_byte(SP + 1, (uint8_t)((PC & 0xff00) >> 8));
-                PC = address;
-                break;
-            } 
-            break;
-        } case 0xD5: { // PUSH DE
-            uint16_t DE = (D << 8) | E;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(DE & 0x00ff));
-            mmu->write_byte(SP + 1, (uint8_t)((DE & 0xff00) >> 8));
-            break;
-        } case 0xD6: { // SUB A, n8
-            uint8_t value = mmu->read_byte(PC++);
-            uint16_t result = A - value;
-            subtractionFlags(A, value, result);
-            A = result & 0xFF;
-            break;
-        } case 0xD7: { // RST $10
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF)); // HIGH byte
-            PC = 0x0010;
-            break;
-        } case 0xD8: { // RET C
-            if (getCarryFlag()) {
-                PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            }
-            break;
-        } case 0xD9: { // RETI
-            IME = true;
-            PC = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            SP += 2;
-            break;
-        } case 0xDA: { // JP C, a16
-            if (getCarryFlag()) {
-                PC = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-                break;
-            }
-            PC += 2;
-            break;
-        } case 0xDC: { // CALL C, a16
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            if (getCarryFlag()) { 
-                SP -= 2;
-                mmu->write_byte(SP, (uint8_t)(PC & 0x00ff));
-                mmu->write_byte(SP + 1, (uint8_t)((PC & 0xff00) >> 8));
-                PC = address;
-                break;
-            } 
-            break;
-        } case 0xDE: { // SBC A, n8
-            uint8_t value = mmu->read_byte(PC++);
-            uint16_t result = A - value - getCarryFlag();
-            subtractionFlags(A, value + getCarryFlag(), result);
-            A = result & 0xFF;
-            break;
-        } case 0xDF: { // RST $18
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF));
-            PC = 0x0018;
-            break;
-        } case 0xE0: { // LDH [a8], A
-            mmu->write_byte(0xFF00 + mmu->read_byte(PC++), A);
-            break;
-        } case 0xE1: { // POP HL
-            uint16_t HL = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            SP += 2;
-
-            H = HL >> 8;
-            L = HL & 0xFF;
-            break;
-        } case 0xE2: { // LD [C], A
-            mmu->write_byte(0xFF00 + C, A);
-            break;
-        } case 0xE5: { // PUSH HL
-            uint16_t HL = (H << 8) | L;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(HL & 0x00ff));
-            mmu->write_byte(SP + 1, (uint8_t)((HL & 0xff00) >> 8));
-            break;
-        } case 0xE6: { // AND A, n8
-            A &= mmu->read_byte(PC++);
-            andFlags(A);
-            break;
-        } case 0xE7: { // RST $20
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF));
-            PC = 0x0020;
-            break;
-        } case 0xE8: { // ADD SP, e8
-            int8_t value = mmu->read_byte(PC++);
-            uint16_t result = SP + value;        
-            setZeroFlag(result == 0);
-            setSubtractFlag(false);
-            setHalfCarryFlag(((SP & 0xF) + (value & 0xF)) > 0xF);
-            setCarryFlag((result > 0xFFFF));
-            SP = result & 0xFFFF;
-            break;
-        } case 0xE9: { // JP HL
-            uint16_t HL = (H << 8) | L;
-            PC = HL;
-            break;
-        } case 0xEA: { // LD [a16], A
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;  // Increment PC after reading address
-            mmu->write_byte(address, A);
-            break;
-        } case 0xEE: { // XOR A, n8
-            A ^= mmu->read_byte(PC++);
-            orFlags(A);
-            break;
-        } case 0xEF: { // RST $28
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF));
-            PC = 0x0028;
-            break;
-        } case 0xF0: { // LDH A, [a8]
-            uint8_t address = mmu->read_byte(PC++);
-            A = mmu->read_byte(0xFF00 + address);
-            break;
-        } case 0xF1: { // POP AF
-            uint16_t AF = mmu->read_byte(SP) | (mmu->read_byte(SP + 1) << 8);
-            SP += 2;
-
-            A = AF >> 8;
-            F = AF & 0xF0;
-            break;
-        } case 0xF2: { // LD A, [C]
-            A = mmu->read_byte(0xFF00 + C);
-            break;
-        } case 0xF3: { // DI
-            IME = false;
-            break;
-        } case 0xF5: { // PUSH AF
-            uint16_t AF = (A << 8) | F;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(AF & 0x00ff));
-            mmu->write_byte(SP + 1, (uint8_t)((AF & 0xff00) >> 8));
-            break;
-        } case 0xF6: { // OR A, n8
-            A |= mmu->read_byte(PC++);
-            orFlags(A);
-            break;
-        } case 0xF7: { // RST $30
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF));
-            PC = 0x0030;
-            break;
-        } case 0xF8: { // LD HL, SP + e8
-            int8_t e8 = mmu->read_byte(PC++);
-            uint16_t result = SP + e8;
-            setZeroFlag(false);
-            setSubtractFlag(false);
-            setHalfCarryFlag(((SP & 0xF) + (e8 & 0xF)) > 0xF);
-            setCarryFlag(((SP & 0xFF) + (e8 & 0xFF)) > 0xFF);
-            H = (result >> 8) & 0xFF;
-            L = result & 0xFF;
-            break;
-        } case 0xF9: { // LD SP, HL
-            SP = (H << 8) | L;
-            break;
-        } case 0xFA: { // LD A, [a16]
-            uint16_t address = mmu->read_byte(PC) | (mmu->read_byte(PC + 1) << 8);
-            PC += 2;
-            A = mmu->read_byte(address);
-            break;
-        } case 0xFB: { // EI
-            IME = true;
-            break;
-        } case 0xFE: { // CP A, n8
-            setSubtractFlag(true);
-            setZeroFlag(A == mmu->read_byte(PC++));
-            setHalfCarryFlag(((A & 0x0F) - (mmu->read_byte(PC) & 0x0F)) < 0);
-            setCarryFlag(A < mmu->read_byte(PC));
-            break;
-        } case 0xFF: { // RST $38
-            uint16_t return_address = PC;
-            SP -= 2;
-            mmu->write_byte(SP, (uint8_t)(return_address & 0x00FF));         // LOW byte
-            mmu->write_byte(SP + 1, (uint8_t)((return_address >> 8) & 0x00FF));
-            PC = 0x0038;
-            break;
-        } default: {
-            std::cout << "Invalid opcode: " << std::hex << (int)opcode << std::endl;
-            break;
-        }
+template <>
+int CPU::op<0x28>() { // JR Z, e8
+    int8_t offset = operand;
+    if (getZeroFlag()) {
+        PC += offset;
+        return 12;
     }
+    return 8;
 }
-
-void CPU::executeCBInstruction(uint8_t cb_opcode) {
-    switch (cb_opcode) {
-        case 0x00: { // RLC B
-            RLC(B);
-            break;
-        } case 0x01: { // RLC C
-            RLC(C);
-            break;
-        } case 0x02: { // RLC D
-            RLC(D);
-            break;
-        } case 0x03: { // RLC E
-            RLC(E);
-            break;
-        } case 0x04: { // RLC H
-            RLC(H);
-            break;
-        } case 0x05: { // RLC L
-            RLC(L);
-            break;
-        } case 0x06: { // RLC [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RLC(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x07: { // RLC A
-            RLC(A);
-            break;
-        } case 0x08: { // RRC B
-            RRC(B);
-            break;
-        } case 0x09: { // RRC C
-            RRC(C);
-            break;
-        } case 0x0A: { // RRC D
-            RRC(D);
-            break;
-        } case 0x0B: { // RRC E
-            RRC(E);
-            break;
-        } case 0x0C: { // RRC H
-            RRC(H);
-            break;
-        } case 0x0D: { // RRC L
-            RRC(L);
-            break;
-        } case 0x0E: { // RRC [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RRC(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x0F: { // RRC A
-            RRC(A);
-            break;
-        } case 0x10: { // RL B
-            RL(B);
-            break;
-        } case 0x11: { // RL C
-            RL(C);
-            break;
-        } case 0x12: { // RL D
-            RL(D);
-            break;
-        } case 0x13: { // RL E
-            RL(E);
-            break;
-        } case 0x14: { // RL H
-            RL(H);
-            break;
-        } case 0x15: { // RL L
-            RL(L);
-            break;
-        } case 0x16: { // RL [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RL(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x17: { // RL A
-            RL(A);
-            break;
-        } case 0x18: { // RR B
-            RR(B);
-            break;
-        } case 0x19: { // RR C
-            RR(C);
-            break;
-        } case 0x1A: { // RR D
-            RR(D);
-            break;
-        } case 0x1B: { // RR E
-            RR(E);
-            break;
-        } case 0x1C: { // RR H
-            RR(H);
-            break;
-        } case 0x1D: { // RR L
-            RR(L);
-            break;
-        } case 0x1E: { // RR [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RR(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x1F: { // RR A
-            RR(A);
-            break;
-        } case 0x20: { // SLA B
-            SLA(B);
-            break;
-        } case 0x21: { // SLA C
-            SLA(C);
-            break;
-        } case 0x22: { // SLA D
-            SLA(D);
-            break;
-        } case 0x23: { // SLA E
-            SLA(E);
-            break;
-        } case 0x24: { // SLA H
-            SLA(H);
-            break;
-        } case 0x25: { // SLA L
-            SLA(L);
-            break;
-        } case 0x26: { // SLA [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SLA(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x27: { // SLA A
-            SLA(A);
-            break;
-        } case 0x28: { // SRA B
-            SRA(B);
-            break;
-        } case 0x29: { // SRA C
-            SRA(C);
-            break;
-        } case 0x2A: { // SRA D
-            SRA(D);
-            break;
-        } case 0x2B: { // SRA E
-            SRA(E);
-            break;
-        } case 0x2C: { // SRA H
-            SRA(H);
-            break;
-        } case 0x2D: { // SRA L
-            SRA(L);
-            break;
-        } case 0x2E: { // SRA [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SRA(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x2F: { // SRA A
-            SRA(A);
-            break;
-        } case 0x30: { // SWAP B
-            SWAP(B);
-            break;
-        } case 0x31: { // SWAP C
-            SWAP(C);
-            break;
-        } case 0x32: { // SWAP D
-            SWAP(D);
-            break;
-        } case 0x33: { // SWAP E
-            SWAP(E);
-            break;
-        } case 0x34: { // SWAP H
-            SWAP(H);
-            break;
-        } case 0x35: { // SWAP L
-            SWAP(L);
-            break;
-        } case 0x36: { // SWAP [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SWAP(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x37: { // SWAP A
-            SWAP(A);
-            break;
-        } case 0x38: { // SRL B
-            SRL(B);
-            break;
-        } case 0x39: { // SRL C
-            SRL(C);
-            break;
-        } case 0x3A: { // SRL D
-            SRL(D);
-            break;
-        } case 0x3B: { // SRL E
-            SRL(E);
-            break;
-        } case 0x3C: { // SRL H
-            SRL(H);
-            break;
-        } case 0x3D: { // SRL L
-            SRL(L);
-            break;
-        } case 0x3E: { // SRL [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SRL(value);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x3F: { // SRL A
-            SRL(A);
-            break;
-        } case 0x40: { // BIT 0, B
-            BIT(B, 0);
-            break;
-        } case 0x41: { // BIT 0, C
-            BIT(C, 0);
-            break;
-        } case 0x42: { // BIT 0, D
-            BIT(D, 0);
-            break;
-        } case 0x43: { // BIT 0, E
-            BIT(E, 0);
-            break;
-        } case 0x44: { // BIT 0, H
-            BIT(H, 0);
-            break;
-        } case 0x45: { // BIT 0, L
-            BIT(L, 0);
-            break;
-        } case 0x46: { // BIT 0, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 0);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x47: { // BIT 0, A
-            BIT(A, 0);
-            break;
-        } case 0x48: { // BIT 1, B
-            BIT(B, 1);
-            break;
-        } case 0x49: { // BIT 1, C
-            BIT(C, 1);
-            break;
-        } case 0x4A: { // BIT 1, D
-            BIT(D, 1);
-            break;
-        } case 0x4B: { // BIT 1, E
-            BIT(E, 1);
-            break;
-        } case 0x4C: { // BIT 1, H
-            BIT(H, 1);
-            break;
-        } case 0x4D: { // BIT 1, L
-            BIT(L, 1);
-            break;
-        } case 0x4E: { // BIT 1, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 1);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x4F: { // BIT 1, A
-            BIT(A, 1);
-            break;
-        } case 0x50: { // BIT 2, B
-            BIT(B, 2);
-            break;
-        } case 0x51: { // BIT 2, C
-            BIT(C, 2);
-            break;
-        } case 0x52: { // BIT 2, D
-            BIT(D, 2);
-            break;
-        } case 0x53: { // BIT 2, E
-            BIT(E, 2);
-            break;
-        } case 0x54: { // BIT 2, H
-            BIT(H, 2);
-            break;
-        } case 0x55: { // BIT 2, L
-            BIT(L, 2);
-            break;
-        } case 0x56: { // BIT 2, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 2);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x57: { // BIT 2, A
-            BIT(A, 2);
-            break;
-        } case 0x58: { // BIT 3, B
-            BIT(B, 3);
-            break;
-        } case 0x59: { // BIT 3, C
-            BIT(C, 3);
-            break;
-        } case 0x5A: { // BIT 3, D
-            BIT(D, 3);
-            break;
-        } case 0x5B: { // BIT 3, E
-            BIT(E, 3);
-            break;
-        } case 0x5C: { // BIT 3, H
-            BIT(H, 3);
-            break;
-        } case 0x5D: { // BIT 3, L
-            BIT(L, 3);
-            break;
-        } case 0x5E: { // BIT 3, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 3);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x5F: { // BIT 3, A
-            BIT(A, 3);
-            break;
-        } case 0x60: { // BIT 4, B
-            BIT(B, 4);
-            break;
-        } case 0x61: { // BIT 4, C
-            BIT(C, 4);
-            break;
-        } case 0x62: { // BIT 4, D
-            BIT(D, 4);
-            break;
-        } case 0x63: { // BIT 4, E
-            BIT(E, 4);
-            break;
-        } case 0x64: { // BIT 4, H
-            BIT(H, 4);
-            break;
-        } case 0x65: { // BIT 4, L
-            BIT(L, 4);
-            break;
-        } case 0x66: { // BIT 4, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 4);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x67: { // BIT 4, A
-            BIT(A, 4);
-            break;
-        } case 0x68: { // BIT 5, B
-            BIT(B, 5);
-            break;
-        } case 0x69: { // BIT 5, C
-            BIT(C, 5);
-            break;
-        } case 0x6A: { // BIT 5, D
-            BIT(D, 5);
-            break;
-        } case 0x6B: { // BIT 5, E
-            BIT(E, 5);
-            break;
-        } case 0x6C: { // BIT 5, H
-            BIT(H, 5);
-            break;
-        } case 0x6D: { // BIT 5, L
-            BIT(L, 5);
-            break;
-        } case 0x6E: { // BIT 5, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 5);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x6F: { // BIT 5, A
-            BIT(A, 5);
-            break;
-        } case 0x70: { // BIT 6, B
-            BIT(B, 6);
-            break;
-        } case 0x71: { // BIT 6, C
-            BIT(C, 6);
-            break;
-        } case 0x72: { // BIT 6, D
-            BIT(D, 6);
-            break;
-        } case 0x73: { // BIT 6, E
-            BIT(E, 6);
-            break;
-        } case 0x74: { // BIT 6, H
-            BIT(H, 6);
-            break;
-        } case 0x75: { // BIT 6, L
-            BIT(L, 6);
-            break;
-        } case 0x76: { // BIT 6, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 6);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x77: { // BIT 6, A
-            BIT(A, 6);
-            break;
-        } case 0x78: { // BIT 7, B
-            BIT(B, 7);
-            break;
-        } case 0x79: { // BIT 7, C
-            BIT(C, 7);
-            break;
-        } case 0x7A: { // BIT 7, D
-            BIT(D, 7);
-            break;
-        } case 0x7B: { // BIT 7, E
-            BIT(E, 7);
-            break;
-        } case 0x7C: { // BIT 7, H
-            BIT(H, 7);
-            break;
-        } case 0x7D: { // BIT 7, L
-            BIT(L, 7);
-            break;
-        } case 0x7E: { // BIT 7, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            BIT(value, 7);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x7F: { // BIT 7, A
-            BIT(A, 7);
-            break;
-        } case 0x80: { // RES 0, B
-            RES(B, 0);
-            break;
-        } case 0x81: { // RES 0, C
-            RES(C, 0);
-            break;
-        } case 0x82: { // RES 0, D
-            RES(D, 0);
-            break;
-        } case 0x83: { // RES 0, E
-            RES(E, 0);
-            break;
-        } case 0x84: { // RES 0, H
-            RES(H, 0);
-            break;
-        } case 0x85: { // RES 0, L
-            RES(L, 0);
-            break;
-        } case 0x86: { // RES 0, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 0);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x87: { // RES 0, A
-            RES(A, 0);
-            break;
-        } case 0x88: { // RES 1, B
-            RES(B, 1);
-            break;
-        } case 0x89: { // RES 1, C
-            RES(C, 1);
-            break;
-        } case 0x8A: { // RES 1, D
-            RES(D, 1);
-            break;
-        } case 0x8B: { // RES 1, E
-            RES(E, 1);
-            break;
-        } case 0x8C: { // RES 1, H
-            RES(H, 1);
-            break;
-        } case 0x8D: { // RES 1, L
-            RES(L, 1);
-            break;
-        } case 0x8E: { // RES 1, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 1);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x8F: { // RES 1, A
-            RES(A, 1);
-            break;
-        } case 0x90: { // RES 2, B
-            RES(B, 2);
-            break;
-        } case 0x91: { // RES 2, C
-            RES(C, 2);
-            break;
-        } case 0x92: { // RES 2, D
-            RES(D, 2);
-            break;
-        } case 0x93: { // RES 2, E
-            RES(E, 2);
-            break;
-        } case 0x94: { // RES 2, H
-            RES(H, 2);
-            break;
-        } case 0x95: { // RES 2, L
-            RES(L, 2);
-            break;
-        } case 0x96: { // RES 2, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 2);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x97: { // RES 2, A
-            RES(A, 2);
-            break;
-        } case 0x98: { // RES 3, B
-            RES(B, 3);
-            break;
-        } case 0x99: { // RES 3, C
-            RES(C, 3);
-            break;
-        } case 0x9A: { // RES 3, D
-            RES(D, 3);
-            break;
-        } case 0x9B: { // RES 3, E
-            RES(E, 3);
-            break;
-        } case 0x9C: { // RES 3, H
-            RES(H, 3);
-            break;
-        } case 0x9D: { // RES 3, L
-            RES(L, 3);
-            break;
-        } case 0x9E: { // RES 3, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 3);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0x9F: { // RES 3, A
-            RES(A, 3);
-            break;
-        } case 0xA0: { // RES 4, B
-            RES(B, 4);
-            break;
-        } case 0xA1: { // RES 4, C
-            RES(C, 4);
-            break;
-        } case 0xA2: { // RES 4, D
-            RES(D, 4);
-            break;
-        } case 0xA3: { // RES 4, E
-            RES(E, 4);
-            break;
-        } case 0xA4: { // RES 4, H
-            RES(H, 4);
-            break;
-        } case 0xA5: { // RES 4, L
-            RES(L, 4);
-            break;
-        } case 0xA6: { // RES 4, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 4);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xA7: { // RES 4, A
-            RES(A, 4);
-            break;
-        } case 0xA8: { // RES 5, B
-            RES(B, 5);
-            break;
-        } case 0xA9: { // RES 5, C
-            RES(C, 5);
-            break;
-        } case 0xAA: { // RES 5, D
-            RES(D, 5);
-            break;
-        } case 0xAB: { // RES 5, E
-            RES(E, 5);
-            break;
-        } case 0xAC: { // RES 5, H
-            RES(H, 5);
-            break;
-        } case 0xAD: { // RES 5, L
-            RES(L, 5);
-            break;
-        } case 0xAE: { // RES 5, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 5);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xAF: { // RES 5, A
-            RES(A, 5);
-            break;
-        } case 0xB0: { // RES 6, B
-            RES(B, 6);
-            break;
-        } case 0xB1: { // RES 6, C
-            RES(C, 6);
-            break;
-        } case 0xB2: { // RES 6, D
-            RES(D, 6);
-            break;
-        } case 0xB3: { // RES 6, E
-            RES(E, 6);
-            break;
-        } case 0xB4: { // RES 6, H
-            RES(H, 6);
-            break;
-        } case 0xB5: { // RES 6, L
-            RES(L, 6);
-            break;
-        } case 0xB6: { // RES 6, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 6);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xB7: { // RES 6, A
-            RES(A, 6);
-            break;
-        } case 0xB8: { // RES 7, B
-            RES(B, 7);
-            break;
-        } case 0xB9: { // RES 7, C
-            RES(C, 7);
-            break;
-        } case 0xBA: { // RES 7, D
-            RES(D, 7);
-            break;
-        } case 0xBB: { // RES 7, E
-            RES(E, 7);
-            break;
-        } case 0xBC: { // RES 7, H
-            RES(H, 7);
-            break;
-        } case 0xBD: { // RES 7, L
-            RES(L, 7);
-            break;
-        } case 0xBE: { // RES 7, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            RES(value, 7);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xBF: { // RES 7, A
-            RES(A, 7);
-            break;
-        } case 0xC0: { // SET 0, B
-            SET(B, 0);
-            break;
-        } case 0xC1: { // SET 0, C
-            SET(C, 0);
-            break;
-        } case 0xC2: { // SET 0, D
-            SET(D, 0);
-            break;
-        } case 0xC3: { // SET 0, E
-            SET(E, 0);
-            break;
-        } case 0xC4: { // SET 0, H
-            SET(H, 0);
-            break;
-        } case 0xC5: { // SET 0, L
-            SET(L, 0);
-            break;
-        } case 0xC6: { // SET 0, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 0);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xC7: { // SET 0, A
-            SET(A, 0);
-            break;
-        } case 0xC8: { // SET 1, B
-            SET(B, 1);
-            break;
-        } case 0xC9: { // SET 1, C
-            SET(C, 1);
-            break;
-        } case 0xCA: { // SET 1, D
-            SET(D, 1);
-            break;
-        } case 0xCB: { // SET 1, E
-            SET(E, 1);
-            break;
-        } case 0xCC: { // SET 1, H
-            SET(H, 1);
-            break;
-        } case 0xCD: { // SET 1, L
-            SET(L, 1);
-            break;
-        } case 0xCE: { // SET 1, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 1);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xCF: { // SET 1, A
-            SET(A, 1);
-            break;
-        } case 0xD0: { // SET 2, B
-            SET(B, 2);
-            break;
-        } case 0xD1: { // SET 2, C
-            SET(C, 2);
-            break;
-        } case 0xD2: { // SET 2, D
-            SET(D, 2);
-            break;
-        } case 0xD3: { // SET 2, E
-            SET(E, 2);
-            break;
-        } case 0xD4: { // SET 2, H
-            SET(H, 2);
-            break;
-        } case 0xD5: { // SET 2, L
-            SET(L, 2);
-            break;
-        } case 0xD6: { // SET 2, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 2);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xD7: { // SET 2, A
-            SET(A, 2);
-            break;
-        } case 0xD8: { // SET 3, B
-            SET(B, 3);
-            break;
-        } case 0xD9: { // SET 3, C
-            SET(C, 3);
-            break;
-        } case 0xDA: { // SET 3, D
-            SET(D, 3);
-            break;
-        } case 0xDB: { // SET 3, E
-            SET(E, 3);
-            break;
-        } case 0xDC: { // SET 3, H
-            SET(H, 3);
-            break;
-        } case 0xDD: { // SET 3, L
-            SET(L, 3);
-            break;
-        } case 0xDE: { // SET 3, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 3);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xDF: { // SET 3, A
-            SET(A, 3);
-            break;
-        } case 0xE0: { // SET 4, B
-            SET(B, 4);
-            break;
-        } case 0xE1: { // SET 4, C
-            SET(C, 4);
-            break;
-        } case 0xE2: { // SET 4, D
-            SET(D, 4);
-            break;
-        } case 0xE3: { // SET 4, E
-            SET(E, 4);
-            break;
-        } case 0xE4: { // SET 4, H
-            SET(H, 4);
-            break;
-        } case 0xE5: { // SET 4, L
-            SET(L, 4);
-            break;
-        } case 0xE6: { // SET 4, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 4);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xE7: { // SET 4, A
-            SET(A, 4);
-            break;
-        } case 0xE8: { // SET 5, B
-            SET(B, 5);
-            break;
-        } case 0xE9: { // SET 5, C
-            SET(C, 5);
-            break;
-        } case 0xEA: { // SET 5, D
-            SET(D, 5);
-            break;
-        } case 0xEB: { // SET 5, E
-            SET(E, 5);
-            break;
-        } case 0xEC: { // SET 5, H
-            SET(H, 5);
-            break;
-        } case 0xED: { // SET 5, L
-            SET(L, 5);
-            break;
-        } case 0xEE: { // SET 5, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 5);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xEF: { // SET 5, A
-            SET(A, 5);
-            break;
-        } case 0xF0: { // SET 6, B
-            SET(B, 6);
-            break;
-        } case 0xF1: { // SET 6, C
-            SET(C, 6);
-            break;
-        } case 0xF2: { // SET 6, D
-            SET(D, 6);
-            break;
-        } case 0xF3: { // SET 6, E
-            SET(E, 6);
-            break;
-        } case 0xF4: { // SET 6, H
-            SET(H, 6);
-            break;
-        } case 0xF5: { // SET 6, L
-            SET(L, 6);
-            break;
-        } case 0xF6: { // SET 6, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 6);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xF7: { // SET 6, A
-            SET(A, 6);
-            break;
-        } case 0xF8: { // SET 7, B
-            SET(B, 7);
-            break;
-        } case 0xF9: { // SET 7, C
-            SET(C, 7);
-            break;
-        } case 0xFA: { // SET 7, D
-            SET(D, 7);
-            break;
-        } case 0xFB: { // SET 7, E
-            SET(E, 7);
-            break;
-        } case 0xFC: { // SET 7, H
-            SET(H, 7);
-            break;
-        } case 0xFD: { // SET 7, L
-            SET(L, 7);
-            break;
-        } case 0xFE: { // SET 7, [HL]
-            uint16_t HL = (H << 8) | L;
-            uint8_t value = mmu->read_byte(HL);
-            SET(value, 7);
-            mmu->write_byte(HL, value);
-            break;
-        } case 0xFF: { // SET 7, A
-            SET(A, 7);
-            break;
+template <>
+int CPU::op<0x29>() { // ADD HL, HL
+    uint32_t result = HL + HL;
+    setSubtractFlag(false);
+    setHalfCarryFlag(((HL & 0x0FFF) + (HL & 0x0FFF)) > 0x0FFF);
+    setCarryFlag(result > 0xFFFF);
+    HL = result;
+    return 8;
+}
+template <>
+int CPU::op<0x2A>() { // LD A, [HL+]
+    A = mmu->read_byte(HL++);
+    return 8;
+}
+template <>
+int CPU::op<0x2B>() { // DEC HL
+    HL--;
+    return 8;
+}
+template <>
+int CPU::op<0x2C>() { // INC L
+    L++;
+    incrementFlags(L);
+    return 4;
+}
+template <>
+int CPU::op<0x2D>() { // DEC L
+    L--;
+    decrementFlags(L);
+    return 4;
+}
+template <>
+int CPU::op<0x2E>() { // LD L, n8
+    L = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x2F>() { // CPL
+    A = ~A;
+    setSubtractFlag(true);
+    setHalfCarryFlag(true);
+    return 4;
+}
+template <>
+int CPU::op<0x30>() { // JR NC, e8
+    int8_t offset = operand;
+    if (!getCarryFlag()) {
+        PC += offset;
+        return 12;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0x31>() { // LD SP, n16
+    SP = operand;
+    return 12;
+}
+template <>
+int CPU::op<0x32>() { // LD [HL-], A
+    mmu->write_byte(HL, A);
+    HL--;
+    return 8;
+}
+template <>
+int CPU::op<0x33>() { // INC SP
+    SP++;
+    return 8;
+}
+template <>
+int CPU::op<0x34>() { // INC [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint8_t result = value + 1;
+    mmu->write_byte(HL, result);
+    setZeroFlag(result == 0);
+    setSubtractFlag(false);
+    setHalfCarryFlag((result & 0x0F) == 0x0F);
+    return 12;
+}
+template <>
+int CPU::op<0x35>() { // DEC [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint8_t result = value - 1;
+    mmu->write_byte(HL, result);
+    setZeroFlag(result == 0);
+    setSubtractFlag(false);
+    setHalfCarryFlag((result & 0x0F) == 0x0F);
+    return 12;
+}
+template <>
+int CPU::op<0x36>() { // LD [HL], n8
+    mmu->write_byte(HL, operand);
+    return 12;
+}
+template <>
+int CPU::op<0x37>() { // SCF
+    setCarryFlag(true);
+    setSubtractFlag(false);
+    setHalfCarryFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x38>() { // JR C, e8
+    int8_t offset = operand;
+    if (getCarryFlag()) {
+        PC += offset;
+        return 12;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0x39>() { // ADD HL, SP
+    uint32_t result = HL + SP;
+    setSubtractFlag(false);
+    setHalfCarryFlag(((HL & 0x0FFF) + (SP & 0x0FFF)) > 0x0FFF);
+    setCarryFlag(result > 0xFFFF);
+    HL = result;
+    return 8;
+}
+template <>
+int CPU::op<0x3A>() { // LD A, [HL-]
+    A = mmu->read_byte(HL--);
+    return 8;
+}
+template <>
+int CPU::op<0x3B>() { // DEC SP
+    SP--;
+    return 8;
+}
+template <>
+int CPU::op<0x3C>() { // INC A
+    A++;
+    incrementFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0x3D>() { // DEC A
+    A--;
+    decrementFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0x3E>() { // LD A, n8
+    A = operand;
+    return 8;
+}
+template <>
+int CPU::op<0x3F>() { // CCF
+    setCarryFlag(!getCarryFlag());
+    setSubtractFlag(false);
+    setHalfCarryFlag(false);
+    return 4;
+}
+template <>
+int CPU::op<0x40>() { // LD B, B
+    B = B;
+    return 4;
+}
+template <>
+int CPU::op<0x41>() { // LD B, C
+    B = C;
+    return 4;
+}
+template <>
+int CPU::op<0x42>() { // LD B, D
+    B = D;
+    return 4;
+}
+template <>
+int CPU::op<0x43>() { // LD B, E
+    B = E;
+    return 4;
+}
+template <>
+int CPU::op<0x44>() { // LD B, H
+    B = H;
+    return 4;
+}
+template <>
+int CPU::op<0x45>() { // LD B, L
+    B = L;
+    return 4;
+}
+template <>
+int CPU::op<0x46>() { // LD B, [HL]
+    B = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x47>() { // LD B, A
+    B = A;
+    return 4;
+}
+template <>
+int CPU::op<0x48>() { // LD C, B
+    C = B;
+    return 4;
+}
+template <>
+int CPU::op<0x49>() { // LD C, C
+    C = C;
+    return 4;
+}
+template <>
+int CPU::op<0x4A>() { // LD C, D
+    C = D;
+    return 4;
+}
+template <>
+int CPU::op<0x4B>() { // LD C, E
+    C = E;
+    return 4;
+}
+template <>
+int CPU::op<0x4C>() { // LD C, H
+    C = H;
+    return 4;
+}
+template <>
+int CPU::op<0x4D>() { // LD C, L
+    C = L;
+    return 4;
+}
+template <>
+int CPU::op<0x4E>() { // LD C, [HL]
+    C = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x4F>() { // LD C, A
+    C = A;
+    return 4;
+}
+template <>
+int CPU::op<0x50>() { // LD D, B
+    D = B;
+    return 4;
+}
+template <>
+int CPU::op<0x51>() { // LD D, C
+    D = C;
+    return 4;
+}
+template <>
+int CPU::op<0x52>() { // LD D, D
+    D = D;
+    return 4;
+}
+template <>
+int CPU::op<0x53>() { // LD D, E
+    D = E;
+    return 4;
+}
+template <>
+int CPU::op<0x54>() { // LD D, H
+    D = H;
+    return 4;
+}
+template <>
+int CPU::op<0x55>() { // LD D, L
+    D = L;
+    return 4;
+}
+template <>
+int CPU::op<0x56>() { // LD D, [HL]
+    D = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x57>() { // LD D, A
+    D = A;
+    return 4;
+}
+template <>
+int CPU::op<0x58>() { // LD E, B
+    E = B;
+    return 4;
+}
+template <>
+int CPU::op<0x59>() { // LD E, C
+    E = C;
+    return 4;
+}
+template <>
+int CPU::op<0x5A>() { // LD E, D
+    E = D;
+    return 4;
+}
+template <>
+int CPU::op<0x5B>() { // LD E, E
+    E = E;
+    return 4;
+}
+template <>
+int CPU::op<0x5C>() { // LD E, H
+    E = H;
+    return 4;
+}
+template <>
+int CPU::op<0x5D>() { // LD E, L
+    E = L;
+    return 4;
+}
+template <>
+int CPU::op<0x5E>() { // LD E, [HL]
+    E = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x5F>() { // LD E, A
+    E = A;
+    return 4;
+}
+template <>
+int CPU::op<0x60>() { // LD H, B
+    H = B;
+    return 4;
+}
+template <>
+int CPU::op<0x61>() { // LD H, C
+    H = C;
+    return 4;
+}
+template <>
+int CPU::op<0x62>() { // LD H, D
+    H = D;
+    return 4;
+}
+template <>
+int CPU::op<0x63>() { // LD H, E
+    H = E;
+    return 4;
+}
+template <>
+int CPU::op<0x64>() { // LD H, H
+    H = H;
+    return 4;
+}
+template <>
+int CPU::op<0x65>() { // LD H, L
+    H = L;
+    return 4;
+}
+template <>
+int CPU::op<0x66>() { // LD H, [HL]
+    H = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x67>() { // LD H, A
+    H = A;
+    return 4;
+}
+template <>
+int CPU::op<0x68>() { // LD L, B
+    L = B;
+    return 4;
+}
+template <>
+int CPU::op<0x69>() { // LD L, C
+    L = C;
+    return 4;
+}
+template <>
+int CPU::op<0x6A>() { // LD L, D
+    L = D;
+    return 4;
+}
+template <>
+int CPU::op<0x6B>() { // LD L, E
+    L = E;
+    return 4;
+}
+template <>
+int CPU::op<0x6C>() { // LD L, H
+    L = H;
+    return 4;
+}
+template <>
+int CPU::op<0x6D>() { // LD L, L
+    L = L;
+    return 4;
+}
+template <>
+int CPU::op<0x6E>() { // LD L, [HL]
+    L = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x6F>() { // LD L, A
+    L = A;
+    return 4;
+}
+template <>
+int CPU::op<0x70>() { // LD [HL], B
+    mmu->write_byte(HL, B);
+    return 8;
+}
+template <>
+int CPU::op<0x71>() { // LD [HL], C
+    mmu->write_byte(HL, C);
+    return 8;
+}
+template <>
+int CPU::op<0x72>() { // LD [HL], D
+    mmu->write_byte(HL, D);
+    return 8;
+}
+template <>
+int CPU::op<0x73>() { // LD [HL], E
+    mmu->write_byte(HL, E);
+    return 8;
+}
+template <>
+int CPU::op<0x74>() { // LD [HL], H
+    mmu->write_byte(HL, H);
+    return 8;
+}
+template <>
+int CPU::op<0x75>() { // LD [HL], L
+    mmu->write_byte(HL, L);
+    return 8;
+}
+template <>
+int CPU::op<0x76>() { // HALT
+    if (!IME && mmu->pending_interrupts) {
+        IME = true;
+        halted = false;
+        return 4;
+    }
+    halted = true;
+    return 4;
+}
+template <>
+int CPU::op<0x77>() { // LD [HL], A
+    mmu->write_byte(HL, A);
+    return 8;
+}
+template <>
+int CPU::op<0x78>() { // LD A, B
+    A = B;
+    return 4;
+}
+template <>
+int CPU::op<0x79>() { // LD A, C
+    A = C;
+    return 4;
+}
+template <>
+int CPU::op<0x7A>() { // LD A, D
+    A = D;
+    return 4;
+}
+template <>
+int CPU::op<0x7B>() { // LD A, E
+    A = E;
+    return 4;
+}
+template <>
+int CPU::op<0x7C>() { // LD A, H
+    A = H;
+    return 4;
+}
+template <>
+int CPU::op<0x7D>() { // LD A, L
+    A = L;
+    return 4;
+}
+template <>
+int CPU::op<0x7E>() { // LD A, [HL]
+    A = mmu->read_byte(HL);
+    return 8;
+}
+template <>
+int CPU::op<0x7F>() { // LD A, A
+    A = A;
+    return 4;
+}
+template <>
+int CPU::op<0x80>() { // ADD A, B
+    uint16_t result = A + B;
+    additionFlags(A, B, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x81>() { // ADD A, C
+    uint16_t result = A + C;
+    additionFlags(A, C, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x82>() { // ADD A, D
+    uint16_t result = A + D;
+    additionFlags(A, D, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x83>() { // ADD A, E
+    uint16_t result = A + E;
+    additionFlags(A, E, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x84>() { // ADD A, H
+    uint16_t result = A + H;
+    additionFlags(A, H, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x85>() { // ADD A, L
+    uint16_t result = A + L;
+    additionFlags(A, L, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x86>() { // ADD A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint16_t result = A + value;
+    additionFlags(A, value, result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0x87>() { // ADD A, A
+    uint16_t result = A + A;
+    additionFlags(A, A, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x88>() { // ADC A, B
+    uint16_t result = A + B + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, B + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x89>() { // ADC A, C
+    uint16_t result = A + C + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, C + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x8A>() { // ADC A, D
+    uint16_t result = A + D + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, D + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x8B>() { // ADC A, E
+    uint16_t result = A + E + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, E + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x8C>() { // ADC A, H
+    uint16_t result = A + H + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, H + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x8D>() { // ADC A, L
+    uint16_t result = A + L + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, L + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x8E>() { // ADC A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint16_t result = A + value + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, value + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0x8F>() { // ADC A, A
+    uint16_t result = A + A + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, A + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x90>() { // SUB A, B
+    uint16_t result = A - B;
+    subtractionFlags(A, B, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x91>() { // SUB A, C
+    uint16_t result = A - C;
+    subtractionFlags(A, C, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x92>() { // SUB A, D
+    uint16_t result = A - D;
+    subtractionFlags(A, D, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x93>() { // SUB A, E
+    uint16_t result = A - E;
+    subtractionFlags(A, E, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x94>() { // SUB A, H
+    uint16_t result = A - H;
+    subtractionFlags(A, H, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x95>() { // SUB A, L
+    uint16_t result = A - L;
+    subtractionFlags(A, L, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x96>() { // SUB A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint16_t result = A - value;
+    subtractionFlags(A, value, result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0x97>() { // SUB A, A
+    uint16_t result = A - A;
+    subtractionFlags(A, L, result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x98>() { // SBC A, B
+    uint16_t result = A - B - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, B + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x99>() { // SBC A, C
+    uint16_t result = A - C - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, C + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x9A>() { // SBC A, D
+    uint16_t result = A - D - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, D + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x9B>() { // SBC A, E
+    uint16_t result = A - E - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, E + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x9C>() { // SBC A, H
+    uint16_t result = A - H - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, H + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x9D>() { // SBC A, L
+    uint16_t result = A - L - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, L + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0x9E>() { // SBC A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    uint16_t result = A - value - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, value, result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0x9F>() { // SBC A, A
+    uint16_t result = A - A - (getCarryFlag() ? 1 : 0);
+    subtractionFlags(A, A + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 4;
+}
+template <>
+int CPU::op<0xA0>() { // AND A, B
+    A &= B;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA1>() { // AND A, C
+    A &= C;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA2>() { // AND A, D
+    A &= D;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA3>() { // AND A, E
+    A &= E;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA4>() { // AND A, H
+    A &= H;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA5>() { // AND A, L
+    A &= L;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA6>() { // AND A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    A &= value;
+    andFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xA7>() { // AND A, A
+    A &= A;
+    andFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA8>() { // XOR A, B
+    A ^= B;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xA9>() { // XOR A, C
+    A ^= C;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xAA>() { // XOR A, D
+    A ^= D;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xAB>() { // XOR A, E
+    A ^= E;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xAC>() { // XOR A, H
+    A ^= H;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xAD>() { // XOR A, L
+    A ^= L;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xAE>() { // XOR A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    A ^= value;
+    orFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xAF>() { // XOR A, A
+    A ^= A;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB0>() { // OR A, B
+    A |= B;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB1>() { // OR A, C
+    A |= C;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB2>() { // OR A, D
+    A |= D;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB3>() { // OR A, E
+    A |= E;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB4>() { // OR A, H
+    A |= H;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB5>() { // OR A, L
+    A |= L;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB6>() { // OR A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    A |= value;
+    orFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xB7>() { // OR A, A
+    A |= A;
+    orFlags(A);
+    return 4;
+}
+template <>
+int CPU::op<0xB8>() { // CP A, B
+    subtractionFlags(A, B, A - B);
+    return 4;
+}
+template <>
+int CPU::op<0xB9>() { // CP A, C
+    subtractionFlags(A, C, A - C);
+    return 4;
+}
+template <>
+int CPU::op<0xBA>() { // CP A, D
+    subtractionFlags(A, D, A - D);
+    return 4;
+}
+template <>
+int CPU::op<0xBB>() { // CP A, E
+    subtractionFlags(A, E, A - E);
+    return 4;
+}
+template <>
+int CPU::op<0xBC>() { // CP A, H
+    subtractionFlags(A, H, A - H);
+    return 4;
+}
+template <>
+int CPU::op<0xBD>() { // CP A, L
+    subtractionFlags(A, L, A - L);
+    return 4;
+}
+template <>
+int CPU::op<0xBE>() { // CP A, [HL]
+    uint8_t value = mmu->read_byte(HL);
+    subtractionFlags(A, value, A - value);
+    return 8;
+}
+template <>
+int CPU::op<0xBF>() { // CP A, A
+    subtractionFlags(A, A, A - A);
+    return 4;
+}
+template <>
+int CPU::op<0xC0>() { // RET NZ
+    if (!getZeroFlag()) {
+        PC = mmu->read_word(SP);
+        SP += 2;
+        return 20;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0xC1>() { // POP BC
+    BC = mmu->read_word(SP);
+    SP += 2;
+    return 12;
+}
+template <>
+int CPU::op<0xC2>() { // JP NZ, a16
+    if (!getZeroFlag()) {
+        PC = operand;
+        return 16;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xC3>() { // JP a16
+    uint16_t address = operand;
+    PC = address;
+    return 16;
+}
+template <>
+int CPU::op<0xC4>() { // CALL NZ, a16
+    uint16_t address = operand;
+    if (!getZeroFlag()) {
+        SP -= 2;
+        mmu->push_word(SP, PC);
+        PC = address;
+        return 24;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xC5>() { // PUSH BC
+    SP -= 2;
+    mmu->push_word(SP, BC);
+    return 16;
+}
+template <>
+int CPU::op<0xC6>() { // ADD A, n8
+    uint8_t value = operand;
+    uint16_t result = A + value;
+    additionFlags(A, value, result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0xC7>() { // RST $00
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0000;
+    return 16;
+}
+template <>
+int CPU::op<0xC8>() { // RET Z
+    if (getZeroFlag()) {
+        PC = mmu->read_word(SP);
+        SP += 2;
+        return 20;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0xC9>() { // RET
+    PC = mmu->read_word(SP);
+    SP += 2;
+    return 16;
+}
+template <>
+int CPU::op<0xCA>() { // JP Z, a16
+    if (getZeroFlag()) {
+        PC = operand;
+        return 16;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xCB>() { // CB PREFIX
+    return executeCBInstruction(operand);
+}
+template <>
+int CPU::op<0xCC>() { // CALL Z, a16
+    uint16_t address = operand;
+    if (getZeroFlag()) {
+        SP -= 2;
+        mmu->push_word(SP, PC);
+        PC = address;
+        return 24;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xCD>() { // CALL a16
+    uint16_t address = operand;
+    SP -= 2;
+    mmu->push_word(SP, PC);
+    PC = address;
+    return 24;
+}
+template <>
+int CPU::op<0xCE>() { // ADC A, n8
+    uint8_t value = operand;
+    uint16_t result = A + value + (getCarryFlag() ? 1 : 0);
+    additionFlags(A, value + (getCarryFlag() ? 1 : 0), result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0xCF>() { // RST $08
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0008;
+    return 16;
+}
+template <>
+int CPU::op<0xD0>() { // RET NC
+    if (!getCarryFlag()) {
+        PC = mmu->read_word(SP);
+        SP += 2;
+        return 20;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0xD1>() { // POP DE
+    DE = mmu->read_word(SP);
+    SP += 2;
+    return 12;
+}
+template <>
+int CPU::op<0xD2>() { // JP NC, a16
+    if (!getCarryFlag()) {
+        PC = operand;
+        return 16;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xD4>() { // CALL NC, a16
+    uint16_t address = operand;
+    if (!getCarryFlag()) {
+        SP -= 2;
+        mmu->push_word(SP, PC);
+        PC = address;
+        return 24;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xD5>() { // PUSH DE
+    SP -= 2;
+    mmu->push_word(SP, DE);
+    return 16;
+}
+template <>
+int CPU::op<0xD6>() { // SUB A, n8
+    uint8_t value = operand;
+    uint16_t result = A - value;
+    subtractionFlags(A, value, result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0xD7>() { // RST $10
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0010;
+    return 16;
+}
+template <>
+int CPU::op<0xD8>() { // RET C
+    if (getCarryFlag()) {
+        PC = mmu->read_word(SP);
+        SP += 2;
+        return 20;
+    }
+    return 8;
+}
+template <>
+int CPU::op<0xD9>() { // RETI
+    IME = true;
+    PC = mmu->read_word(SP);
+    SP += 2;
+    return 16;
+}
+template <>
+int CPU::op<0xDA>() { // JP C, a16
+    if (getCarryFlag()) {
+        PC = operand;
+        return 16;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xDC>() { // CALL C, a16
+    uint16_t address = operand;
+    if (getCarryFlag()) {
+        SP -= 2;
+        mmu->push_word(SP, PC);
+        PC = address;
+        return 24;
+    }
+    return 12;
+}
+template <>
+int CPU::op<0xDE>() { // SBC A, n8
+    uint8_t value = operand;
+    uint16_t result = A - value - getCarryFlag();
+    subtractionFlags(A, value + getCarryFlag(), result);
+    A = result & 0xFF;
+    return 8;
+}
+template <>
+int CPU::op<0xDF>() { // RST $18
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0018;
+    return 16;
+}
+template <>
+int CPU::op<0xE0>() { // LDH [a8], A
+    mmu->write_byte(0xFF00 + operand, A);
+    return 12;
+}
+template <>
+int CPU::op<0xE1>() { // POP HL
+    HL = mmu->read_word(SP);
+    SP += 2;
+    return 12;
+}
+template <>
+int CPU::op<0xE2>() { // LD [C], A
+    mmu->write_byte(0xFF00 + C, A);
+    return 8;
+}
+template <>
+int CPU::op<0xE5>() { // PUSH HL
+    SP -= 2;
+    mmu->push_word(SP, HL);
+    return 16;
+}
+template <>
+int CPU::op<0xE6>() { // AND A, n8
+    A &= operand;
+    andFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xE7>() { // RST $20
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0020;
+    return 16;
+}
+template <>
+int CPU::op<0xE8>() { // ADD SP, e8
+    int8_t value = operand;
+    uint16_t result = SP + value;
+    setZeroFlag(result == 0);
+    setSubtractFlag(false);
+    setHalfCarryFlag(((SP & 0xF) + (value & 0xF)) > 0xF);
+    setCarryFlag((result > 0xFFFF));
+    SP = result & 0xFFFF;
+    return 16;
+}
+template <>
+int CPU::op<0xE9>() { // JP HL
+    PC = HL;
+    return 4;
+}
+template <>
+int CPU::op<0xEA>() { // LD [a16], A
+    uint16_t address = operand;
+    mmu->write_byte(address, A);
+    return 16;
+}
+template <>
+int CPU::op<0xEE>() { // XOR A, n8
+    A ^= operand;
+    orFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xEF>() { // RST $28
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0028;
+    return 16;
+}
+template <>
+int CPU::op<0xF0>() { // LDH A, [a8]
+    uint8_t address = operand;
+    A = mmu->read_byte(0xFF00 + address);
+    return 12;
+}
+template <>
+int CPU::op<0xF1>() { // POP AF
+    uint16_t value = mmu->read_word(SP);
+    SP += 2;
+
+    A = value >> 8;
+    setFlags(value & 0xF0);
+    return 12;
+}
+template <>
+int CPU::op<0xF2>() { // LD A, [C]
+    A = mmu->read_byte(0xFF00 + C);
+    return 8;
+}
+template <>
+int CPU::op<0xF3>() { // DI
+    IME = false;
+    return 4;
+}
+template <>
+int CPU::op<0xF5>() { // PUSH AF
+    getFlags(); // Bring F up to date before pushing the pair
+    SP -= 2;
+    mmu->push_word(SP, AF);
+    return 16;
+}
+template <>
+int CPU::op<0xF6>() { // OR A, n8
+    A |= operand;
+    orFlags(A);
+    return 8;
+}
+template <>
+int CPU::op<0xF7>() { // RST $30
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0030;
+    return 16;
+}
+template <>
+int CPU::op<0xF8>() { // LD HL, SP + e8
+    int8_t e8 = operand;
+    uint16_t result = SP + e8;
+    setZeroFlag(false);
+    setSubtractFlag(false);
+    setHalfCarryFlag(((SP & 0xF) + (e8 & 0xF)) > 0xF);
+    setCarryFlag(((SP & 0xFF) + (e8 & 0xFF)) > 0xFF);
+    HL = result;
+    return 12;
+}
+template <>
+int CPU::op<0xF9>() { // LD SP, HL
+    SP = HL;
+    return 8;
+}
+template <>
+int CPU::op<0xFA>() { // LD A, [a16]
+    uint16_t address = operand;
+    A = mmu->read_byte(address);
+    return 16;
+}
+template <>
+int CPU::op<0xFB>() { // EI
+    IME = true;
+    return 4;
+}
+template <>
+int CPU::op<0xFE>() { // CP A, n8
+    uint8_t value = operand;
+    subtractionFlags(A, value, A - value);
+    return 8;
+}
+template <>
+int CPU::op<0xFF>() { // RST $38
+    uint16_t return_address = PC;
+    SP -= 2;
+    mmu->push_word(SP, return_address);
+    PC = 0x0038;
+    return 16;
+}
+
+// CB-prefixed opcodes form a regular grid: bits 0-2 select the register (6 is [HL]),
+// bits 3-5 the bit index (or which rotate/shift for 0x00-0x3F) and bits 6-7 the group.
+// Every table entry is generated from the kernel below at compile time.
+template <uint8_t opcode>
+int CPU::cb() {
+    constexpr CBOperation operation = opcode < 0x40 ? CBOperation(opcode >> 3) : CBOperation(CB_BIT + (opcode >> 6) - 1);
+    return CBkernel<operation, (opcode >> 3) & 7, opcode & 7>();
+}
+
+template <CPU::CBOperation operation, uint8_t bit, uint8_t reg>
+int CPU::CBkernel() {
+    if constexpr (reg == 6) { // [HL] operand, BIT only reads it back
+        uint8_t value = mmu->read_byte(HL);
+        CBoperation<operation, bit>(value);
+        if constexpr (operation == CB_BIT) {
+            return 12;
+        }
+        mmu->write_byte(HL, value);
+        return 16;
+    } else {
+        CBoperation<operation, bit>(registerByIndex<reg>());
+        return 8;
+    }
+}
+
+template <CPU::CBOperation operation, uint8_t bit>
+void CPU::CBoperation(uint8_t& value) {
+    if constexpr (operation == CB_RLC) {
+        RLC(value);
+    } else if constexpr (operation == CB_RRC) {
+        RRC(value);
+    } else if constexpr (operation == CB_RL) {
+        RL(value);
+    } else if constexpr (operation == CB_RR) {
+        RR(value);
+    } else if constexpr (operation == CB_SLA) {
+        SLA(value);
+    } else if constexpr (operation == CB_SRA) {
+        SRA(value);
+    } else if constexpr (operation == CB_SWAP) {
+        SWAP(value);
+    } else if constexpr (operation == CB_SRL) {
+        SRL(value);
+    } else if constexpr (operation == CB_BIT) {
+        BIT(value, 1 << bit);
+    } else if constexpr (operation == CB_RES) {
+        RES(value, 1 << bit);
+    } else {
+        SET(value, 1 << bit);
+    }
+}
+
+// Register operand order used by the opcode encoding: B, C, D, E, H, L, [HL], A
+template <uint8_t reg>
+uint8_t& CPU::registerByIndex() {
+    static_assert(reg != 6, "index 6 is the [HL] memory operand");
+    if constexpr (reg == 0) {
+        return B;
+    } else if constexpr (reg == 1) {
+        return C;
+    } else if constexpr (reg == 2) {
+        return D;
+    } else if constexpr (reg == 3) {
+        return E;
+    } else if constexpr (reg == 4) {
+        return H;
+    } else if constexpr (reg == 5) {
+        return L;
+    } else {
+        return A;
+    }
+}
+
+const Handler CPU::opcodes[256] = {
+    &CPU::op<0x00>, &CPU::op<0x01>, &CPU::op<0x02>, &CPU::op<0x03>, &CPU::op<0x04>, &CPU::op<0x05>, &CPU::op<0x06>, &CPU::op<0x07>,
+    &CPU::op<0x08>, &CPU::op<0x09>, &CPU::op<0x0A>, &CPU::op<0x0B>, &CPU::op<0x0C>, &CPU::op<0x0D>, &CPU::op<0x0E>, &CPU::op<0x0F>,
+    &CPU::op<0x10>, &CPU::op<0x11>, &CPU::op<0x12>, &CPU::op<0x13>, &CPU::op<0x14>, &CPU::op<0x15>, &CPU::op<0x16>, &CPU::op<0x17>,
+    &CPU::op<0x18>, &CPU::op<0x19>, &CPU::op<0x1A>, &CPU::op<0x1B>, &CPU::op<0x1C>, &CPU::op<0x1D>, &CPU::op<0x1E>, &CPU::op<0x1F>,
+    &CPU::op<0x20>, &CPU::op<0x21>, &CPU::op<0x22>, &CPU::op<0x23>, &CPU::op<0x24>, &CPU::op<0x25>, &CPU::op<0x26>, &CPU::op<0x27>,
+    &CPU::op<0x28>, &CPU::op<0x29>, &CPU::op<0x2A>, &CPU::op<0x2B>, &CPU::op<0x2C>, &CPU::op<0x2D>, &CPU::op<0x2E>, &CPU::op<0x2F>,
+    &CPU::op<0x30>, &CPU::op<0x31>, &CPU::op<0x32>, &CPU::op<0x33>, &CPU::op<0x34>, &CPU::op<0x35>, &CPU::op<0x36>, &CPU::op<0x37>,
+    &CPU::op<0x38>, &CPU::op<0x39>, &CPU::op<0x3A>, &CPU::op<0x3B>, &CPU::op<0x3C>, &CPU::op<0x3D>, &CPU::op<0x3E>, &CPU::op<0x3F>,
+    &CPU::op<0x40>, &CPU::op<0x41>, &CPU::op<0x42>, &CPU::op<0x43>, &CPU::op<0x44>, &CPU::op<0x45>, &CPU::op<0x46>, &CPU::op<0x47>,
+    &CPU::op<0x48>, &CPU::op<0x49>, &CPU::op<0x4A>, &CPU::op<0x4B>, &CPU::op<0x4C>, &CPU::op<0x4D>, &CPU::op<0x4E>, &CPU::op<0x4F>,
+    &CPU::op<0x50>, &CPU::op<0x51>, &CPU::op<0x52>, &CPU::op<0x53>, &CPU::op<0x54>, &CPU::op<0x55>, &CPU::op<0x56>, &CPU::op<0x57>,
+    &CPU::op<0x58>, &CPU::op<0x59>, &CPU::op<0x5A>, &CPU::op<0x5B>, &CPU::op<0x5C>, &CPU::op<0x5D>, &CPU::op<0x5E>, &CPU::op<0x5F>,
+    &CPU::op<0x60>, &CPU::op<0x61>, &CPU::op<0x62>, &CPU::op<0x63>, &CPU::op<0x64>, &CPU::op<0x65>, &CPU::op<0x66>, &CPU::op<0x67>,
+    &CPU::op<0x68>, &CPU::op<0x69>, &CPU::op<0x6A>, &CPU::op<0x6B>, &CPU::op<0x6C>, &CPU::op<0x6D>, &CPU::op<0x6E>, &CPU::op<0x6F>,
+    &CPU::op<0x70>, &CPU::op<0x71>, &CPU::op<0x72>, &CPU::op<0x73>, &CPU::op<0x74>, &CPU::op<0x75>, &CPU::op<0x76>, &CPU::op<0x77>,
+    &CPU::op<0x78>, &CPU::op<0x79>, &CPU::op<0x7A>, &CPU::op<0x7B>, &CPU::op<0x7C>, &CPU::op<0x7D>, &CPU::op<0x7E>, &CPU::op<0x7F>,
+    &CPU::op<0x80>, &CPU::op<0x81>, &CPU::op<0x82>, &CPU::op<0x83>, &CPU::op<0x84>, &CPU::op<0x85>, &CPU::op<0x86>, &CPU::op<0x87>,
+    &CPU::op<0x88>, &CPU::op<0x89>, &CPU::op<0x8A>, &CPU::op<0x8B>, &CPU::op<0x8C>, &CPU::op<0x8D>, &CPU::op<0x8E>, &CPU::op<0x8F>,
+    &CPU::op<0x90>, &CPU::op<0x91>, &CPU::op<0x92>, &CPU::op<0x93>, &CPU::op<0x94>, &CPU::op<0x95>, &CPU::op<0x96>, &CPU::op<0x97>,
+    &CPU::op<0x98>, &CPU::op<0x99>, &CPU::op<0x9A>, &CPU::op<0x9B>, &CPU::op<0x9C>, &CPU::op<0x9D>, &CPU::op<0x9E>, &CPU::op<0x9F>,
+    &CPU::op<0xA0>, &CPU::op<0xA1>, &CPU::op<0xA2>, &CPU::op<0xA3>, &CPU::op<0xA4>, &CPU::op<0xA5>, &CPU::op<0xA6>, &CPU::op<0xA7>,
+    &CPU::op<0xA8>, &CPU::op<0xA9>, &CPU::op<0xAA>, &CPU::op<0xAB>, &CPU::op<0xAC>, &CPU::op<0xAD>, &CPU::op<0xAE>, &CPU::op<0xAF>,
+    &CPU::op<0xB0>, &CPU::op<0xB1>, &CPU::op<0xB2>, &CPU::op<0xB3>, &CPU::op<0xB4>, &CPU::op<0xB5>, &CPU::op<0xB6>, &CPU::op<0xB7>,
+    &CPU::op<0xB8>, &CPU::op<0xB9>, &CPU::op<0xBA>, &CPU::op<0xBB>, &CPU::op<0xBC>, &CPU::op<0xBD>, &CPU::op<0xBE>, &CPU::op<0xBF>,
+    &CPU::op<0xC0>, &CPU::op<0xC1>, &CPU::op<0xC2>, &CPU::op<0xC3>, &CPU::op<0xC4>, &CPU::op<0xC5>, &CPU::op<0xC6>, &CPU::op<0xC7>,
+    &CPU::op<0xC8>, &CPU::op<0xC9>, &CPU::op<0xCA>, &CPU::op<0xCB>, &CPU::op<0xCC>, &CPU::op<0xCD>, &CPU::op<0xCE>, &CPU::op<0xCF>,
+    &CPU::op<0xD0>, &CPU::op<0xD1>, &CPU::op<0xD2>, &CPU::op<0xD3>, &CPU::op<0xD4>, &CPU::op<0xD5>, &CPU::op<0xD6>, &CPU::op<0xD7>,
+    &CPU::op<0xD8>, &CPU::op<0xD9>, &CPU::op<0xDA>, &CPU::op<0xDB>, &CPU::op<0xDC>, &CPU::op<0xDD>, &CPU::op<0xDE>, &CPU::op<0xDF>,
+    &CPU::op<0xE0>, &CPU::op<0xE1>, &CPU::op<0xE2>, &CPU::op<0xE3>, &CPU::op<0xE4>, &CPU::op<0xE5>, &CPU::op<0xE6>, &CPU::op<0xE7>,
+    &CPU::op<0xE8>, &CPU::op<0xE9>, &CPU::op<0xEA>, &CPU::op<0xEB>, &CPU::op<0xEC>, &CPU::op<0xED>, &CPU::op<0xEE>, &CPU::op<0xEF>,
+    &CPU::op<0xF0>, &CPU::op<0xF1>, &CPU::op<0xF2>, &CPU::op<0xF3>, &CPU::op<0xF4>, &CPU::op<0xF5>, &CPU::op<0xF6>, &CPU::op<0xF7>,
+    &CPU::op<0xF8>, &CPU::op<0xF9>, &CPU::op<0xFA>, &CPU::op<0xFB>, &CPU::op<0xFC>, &CPU::op<0xFD>, &CPU::op<0xFE>, &CPU::op<0xFF>
+};
+const Handler CPU::CBopcodes[256] = {
+    &CPU::cb<0x00>, &CPU::cb<0x01>, &CPU::cb<0x02>, &CPU::cb<0x03>, &CPU::cb<0x04>, &CPU::cb<0x05>, &CPU::cb<0x06>, &CPU::cb<0x07>,
+    &CPU::cb<0x08>, &CPU::cb<0x09>, &CPU::cb<0x0A>, &CPU::cb<0x0B>, &CPU::cb<0x0C>, &CPU::cb<0x0D>, &CPU::cb<0x0E>, &CPU::cb<0x0F>,
+    &CPU::cb<0x10>, &CPU::cb<0x11>, &CPU::cb<0x12>, &CPU::cb<0x13>, &CPU::cb<0x14>, &CPU::cb<0x15>, &CPU::cb<0x16>, &CPU::cb<0x17>,
+    &CPU::cb<0x18>, &CPU::cb<0x19>, &CPU::cb<0x1A>, &CPU::cb<0x1B>, &CPU::cb<0x1C>, &CPU::cb<0x1D>, &CPU::cb<0x1E>, &CPU::cb<0x1F>,
+    &CPU::cb<0x20>, &CPU::cb<0x21>, &CPU::cb<0x22>, &CPU::cb<0x23>, &CPU::cb<0x24>, &CPU::cb<0x25>, &CPU::cb<0x26>, &CPU::cb<0x27>,
+    &CPU::cb<0x28>, &CPU::cb<0x29>, &CPU::cb<0x2A>, &CPU::cb<0x2B>, &CPU::cb<0x2C>, &CPU::cb<0x2D>, &CPU::cb<0x2E>, &CPU::cb<0x2F>,
+    &CPU::cb<0x30>, &CPU::cb<0x31>, &CPU::cb<0x32>, &CPU::cb<0x33>, &CPU::cb<0x34>, &CPU::cb<0x35>, &CPU::cb<0x36>, &CPU::cb<0x37>,
+    &CPU::cb<0x38>, &CPU::cb<0x39>, &CPU::cb<0x3A>, &CPU::cb<0x3B>, &CPU::cb<0x3C>, &CPU::cb<0x3D>, &CPU::cb<0x3E>, &CPU::cb<0x3F>,
+    &CPU::cb<0x40>, &CPU::cb<0x41>, &CPU::cb<0x42>, &CPU::cb<0x43>, &CPU::cb<0x44>, &CPU::cb<0x45>, &CPU::cb<0x46>, &CPU::cb<0x47>,
+    &CPU::cb<0x48>, &CPU::cb<0x49>, &CPU::cb<0x4A>, &CPU::cb<0x4B>, &CPU::cb<0x4C>, &CPU::cb<0x4D>, &CPU::cb<0x4E>, &CPU::cb<0x4F>,
+    &CPU::cb<0x50>, &CPU::cb<0x51>, &CPU::cb<0x52>, &CPU::cb<0x53>, &CPU::cb<0x54>, &CPU::cb<0x55>, &CPU::cb<0x56>, &CPU::cb<0x57>,
+    &CPU::cb<0x58>, &CPU::cb<0x59>, &CPU::cb<0x5A>, &CPU::cb<0x5B>, &CPU::cb<0x5C>, &CPU::cb<0x5D>, &CPU::cb<0x5E>, &CPU::cb<0x5F>,
+    &CPU::cb<0x60>, &CPU::cb<0x61>, &CPU::cb<0x62>, &CPU::cb<0x63>, &CPU::cb<0x64>, &CPU::cb<0x65>, &CPU::cb<0x66>, &CPU::cb<0x67>,
+    &CPU::cb<0x68>, &CPU::cb<0x69>, &CPU::cb<0x6A>, &CPU::cb<0x6B>, &CPU::cb<0x6C>, &CPU::cb<0x6D>, &CPU::cb<0x6E>, &CPU::cb<0x6F>,
+    &CPU::cb<0x70>, &CPU::cb<0x71>, &CPU::cb<0x72>, &CPU::cb<0x73>, &CPU::cb<0x74>, &CPU::cb<0x75>, &CPU::cb<0x76>, &CPU::cb<0x77>,
+    &CPU::cb<0x78>, &CPU::cb<0x79>, &CPU::cb<0x7A>, &CPU::cb<0x7B>, &CPU::cb<0x7C>, &CPU::cb<0x7D>, &CPU::cb<0x7E>, &CPU::cb<0x7F>,
+    &CPU::cb<0x80>, &CPU::cb<0x81>, &CPU::cb<0x82>, &CPU::cb<0x83>, &CPU::cb<0x84>, &CPU::cb<0x85>, &CPU::cb<0x86>, &CPU::cb<0x87>,
+    &CPU::cb<0x88>, &CPU::cb<0x89>, &CPU::cb<0x8A>, &CPU::cb<0x8B>, &CPU::cb<0x8C>, &CPU::cb<0x8D>, &CPU::cb<0x8E>, &CPU::cb<0x8F>,
+    &CPU::cb<0x90>, &CPU::cb<0x91>, &CPU::cb<0x92>, &CPU::cb<0x93>, &CPU::cb<0x94>, &CPU::cb<0x95>, &CPU::cb<0x96>, &CPU::cb<0x97>,
+    &CPU::cb<0x98>, &CPU::cb<0x99>, &CPU::cb<0x9A>, &CPU::cb<0x9B>, &CPU::cb<0x9C>, &CPU::cb<0x9D>, &CPU::cb<0x9E>, &CPU::cb<0x9F>,
+    &CPU::cb<0xA0>, &CPU::cb<0xA1>, &CPU::cb<0xA2>, &CPU::cb<0xA3>, &CPU::cb<0xA4>, &CPU::cb<0xA5>, &CPU::cb<0xA6>, &CPU::cb<0xA7>,
+    &CPU::cb<0xA8>, &CPU::cb<0xA9>, &CPU::cb<0xAA>, &CPU::cb<0xAB>, &CPU::cb<0xAC>, &CPU::cb<0xAD>, &CPU::cb<0xAE>, &CPU::cb<0xAF>,
+    &CPU::cb<0xB0>, &CPU::cb<0xB1>, &CPU::cb<0xB2>, &CPU::cb<0xB3>, &CPU::cb<0xB4>, &CPU::cb<0xB5>, &CPU::cb<0xB6>, &CPU::cb<0xB7>,
+    &CPU::cb<0xB8>, &CPU::cb<0xB9>, &CPU::cb<0xBA>, &CPU::cb<0xBB>, &CPU::cb<0xBC>, &CPU::cb<0xBD>, &CPU::cb<0xBE>, &CPU::cb<0xBF>,
+    &CPU::cb<0xC0>, &CPU::cb<0xC1>, &CPU::cb<0xC2>, &CPU::cb<0xC3>, &CPU::cb<0xC4>, &CPU::cb<0xC5>, &CPU::cb<0xC6>, &CPU::cb<0xC7>,
+    &CPU::cb<0xC8>, &CPU::cb<0xC9>, &CPU::cb<0xCA>, &CPU::cb<0xCB>, &CPU::cb<0xCC>, &CPU::cb<0xCD>, &CPU::cb<0xCE>, &CPU::cb<0xCF>,
+    &CPU::cb<0xD0>, &CPU::cb<0xD1>, &CPU::cb<0xD2>, &CPU::cb<0xD3>, &CPU::cb<0xD4>, &CPU::cb<0xD5>, &CPU::cb<0xD6>, &CPU::cb<0xD7>,
+    &CPU::cb<0xD8>, &CPU::cb<0xD9>, &CPU::cb<0xDA>, &CPU::cb<0xDB>, &CPU::cb<0xDC>, &CPU::cb<0xDD>, &CPU::cb<0xDE>, &CPU::cb<0xDF>,
+    &CPU::cb<0xE0>, &CPU::cb<0xE1>, &CPU::cb<0xE2>, &CPU::cb<0xE3>, &CPU::cb<0xE4>, &CPU::cb<0xE5>, &CPU::cb<0xE6>, &CPU::cb<0xE7>,
+    &CPU::cb<0xE8>, &CPU::cb<0xE9>, &CPU::cb<0xEA>, &CPU::cb<0xEB>, &CPU::cb<0xEC>, &CPU::cb<0xED>, &CPU::cb<0xEE>, &CPU::cb<0xEF>,
+    &CPU::cb<0xF0>, &CPU::cb<0xF1>, &CPU::cb<0xF2>, &CPU::cb<0xF3>, &CPU::cb<0xF4>, &CPU::cb<0xF5>, &CPU::cb<0xF6>, &CPU::cb<0xF7>,
+    &CPU::cb<0xF8>, &CPU::cb<0xF9>, &CPU::cb<0xFA>, &CPU::cb<0xFB>, &CPU::cb<0xFC>, &CPU::cb<0xFD>, &CPU::cb<0xFE>, &CPU::cb<0xFF>
+};
+
+// Superinstructions: idioms that dominate the opcode pair counts, run from one
+// dispatch. The block cache installs the handler on the first op of a match; the
+// other ops stay in the block, so a sequence cut short resumes from them.
+const CPU::Fusion CPU::fusions[] = {
+    {{0x2A, 0x12, 0x13}, 3, &CPU::fused<0x2A, 0x12, 0x13>}, // LD A, [HL+]; LD [DE], A; INC DE
+    {{0x2A, 0x12}, 2, &CPU::fused<0x2A, 0x12>},             // LD A, [HL+]; LD [DE], A
+    {{0x1A, 0x22}, 2, &CPU::fused<0x1A, 0x22>},             // LD A, [DE]; LD [HL+], A
+    {{0x22, 0x05}, 2, &CPU::fused<0x22, 0x05>},             // LD [HL+], A; DEC B
+    {{0x22, 0x0D}, 2, &CPU::fused<0x22, 0x0D>},             // LD [HL+], A; DEC C
+    {{0x78, 0xB1, 0x20}, 3, &CPU::fused<0x78, 0xB1, 0x20>}, // LD A, B; OR C; JR NZ
+    {{0x05, 0x20}, 2, &CPU::fused<0x05, 0x20>},             // DEC B; JR NZ
+    {{0x0D, 0x20}, 2, &CPU::fused<0x0D, 0x20>},             // DEC C; JR NZ
+    {{0x15, 0x20}, 2, &CPU::fused<0x15, 0x20>},             // DEC D; JR NZ
+    {{0x1D, 0x20}, 2, &CPU::fused<0x1D, 0x20>},             // DEC E; JR NZ
+    {{0x3D, 0x20}, 2, &CPU::fused<0x3D, 0x20>},             // DEC A; JR NZ
+    {{0xF0, 0xE6}, 2, &CPU::fused<0xF0, 0xE6>},             // LDH A, [n8]; AND n8
+    {{0xF0, 0xFE}, 2, &CPU::fused<0xF0, 0xFE>},             // LDH A, [n8]; CP n8
+};
+
+// Installs a superinstruction on ops[0] if the ops starting there match one.
+// Returns how many ops it covers, 0 if none. Profiling and trace builds count or
+// log every instruction on its own, so they never fuse.
+int CPU::fuse(MicroOp *ops, size_t count) {
+#if defined(OPCODE_PROFILER) || defined(SAMPLING_PROFILER) || defined(DEBUG_TRACE)
+    (void)ops; (void)count;
+    return 0;
+#else
+    for (const Fusion &fusion : fusions) {
+        if (fusion.count > count) {
+            continue;
+        }
+        bool match = true;
+        for (int i = 0; i < fusion.count; i++) {
+            match = match && ops[i].opcode == fusion.opcodes[i];
+        }
+        if (match) {
+            ops[0].handler = fusion.handler;
+            return fusion.count;
+        }
+    }
+    return 0;
+#endif
+}
+
+// Whether the next op of a superinstruction can run straight away. It can't if the
+// block was invalidated or its bank switched out, if an event fell due within the
+// cycles run so far, since the next op would see the timer, PPU and DMA as they were
+// before it, or, with IME set, if an interrupt is already pending.
+bool CPU::fusedBoundary(int cycles) {
+    if (block_exit || scheduler->cycles_until_next_event() <= cycles) {
+        return false;
+    }
+    return !IME || mmu->pending_interrupts == 0;
+}
+
+template <uint8_t first, uint8_t... rest>
+int CPU::fused() {
+    block_exit = false;
+    return fusedNext<rest...>(op<first>());
+}
+
+template <uint8_t opcode, uint8_t... rest>
+int CPU::fusedNext(int cycles) {
+    if (!fusedBoundary(cycles)) {
+        return cycles; // The block cache resumes at the next op
+    }
+    const MicroOp &next = block_cache.next();
+    operand = next.operand;
+    PC += next.length;
+    cycles += op<opcode>();
+    if constexpr (sizeof...(rest) > 0) {
+        return fusedNext<rest...>(cycles);
+    }
+    return cycles;
+}
+
+// Whether opNoFlags has a variant of opcode: INC r, DEC r and the 8-bit ALU ops
+// on a register or an immediate
+static constexpr bool hasFlaglessVariant(uint8_t opcode) {
+    if (opcode < 0x40) {
+        return (opcode & 0x06) == 0x04 && (opcode >> 3) != 6;
+    }
+    return (opcode >= 0x80 && opcode < 0xC0 && (opcode & 0x07) != 6) || (opcode >= 0xC0 && (opcode & 0x07) == 6);
+}
+
+// The result of the op without recording anything for its flags, for ops whose
+// flags the block overwrites before anything reads them. ADC and SBC still read C.
+template <uint8_t opcode>
+int CPU::opNoFlags() {
+    if constexpr (opcode < 0x40) {
+        uint8_t &target = registerByIndex<(opcode >> 3) & 0x07>();
+        if constexpr ((opcode & 0x07) == 4) {
+            target++;
+        } else {
+            target--;
         }
-        default: {
-            throw std::runtime_error("Unhandled CB-prefixed opcode: " + std::to_string(cb_opcode));
+        return 4;
+    } else {
+        uint8_t value;
+        if constexpr (opcode >= 0xC0) {
+            value = operand;
+        } else {
+            value = registerByIndex<opcode & 0x07>();
         }
+        switch ((opcode >> 3) & 0x07) {
+            case 0: A += value; break;
+            case 1: A += value + getCarryFlag(); break;
+            case 2: A -= value; break;
+            case 3: A -= value + getCarryFlag(); break;
+            case 4: A &= value; break;
+            case 5: A ^= value; break;
+            case 6: A |= value; break;
+            case 7: break; // CP only sets flags
+        }
+        return (opcode >= 0xC0) ? 8 : 4;
+    }
+}
+
+template <size_t... opcode>
+std::array<Handler, 256> CPU::flaglessTable(std::index_sequence<opcode...>) {
+    return {{flaglessHandler<opcode>()...}};
+}
+
+template <uint8_t opcode>
+constexpr Handler CPU::flaglessHandler() {
+    if constexpr (hasFlaglessVariant(opcode)) {
+        return &CPU::opNoFlags<opcode>;
+    } else {
+        return nullptr;
     }
 }
 
+const std::array<Handler, 256> CPU::flaglessOpcodes = CPU::flaglessTable(std::make_index_sequence<256>());
+
 void CPU::incrementFlags(uint8_t register1) {
-    setZeroFlag(register1 == 0);
-    setSubtractFlag(false);
-    setHalfCarryFlag((register1 & 0x0F) == 0);
+    flag_carry = getCarryFlag();
+    flag_operation = FLAGS_INC;
+    flag_result = register1;
 }
 void CPU::decrementFlags(uint8_t register1) {
-    setZeroFlag(register1 == 0);
-    setSubtractFlag(true);
-    setHalfCarryFlag((register1 & 0x0F) == 0x0F);
+    flag_carry = getCarryFlag();
+    flag_operation = FLAGS_DEC;
+    flag_result = register1;
 }
 void CPU::additionFlags(uint8_t register1, uint8_t value, uint16_t result) {
-    setZeroFlag((result & 0xFF) == 0);
-    setSubtractFlag(false);
-    setHalfCarryFlag(((register1 & 0x0F) + (value & 0x0F)) > 0x0F);
-    setCarryFlag(result > 0xFF);
+    flag_operation = FLAGS_ADD;
+    flag_operand1 = register1;
+    flag_operand2 = value;
+    flag_result = result;
 }
 void CPU::subtractionFlags(uint8_t register1, uint8_t value, uint16_t result) {
-    setSubtractFlag(true);
-    setHalfCarryFlag((register1 & 0xF) < (value & 0xF));
-    setCarryFlag(register1 < value);
-    setZeroFlag(result == 0);
+    flag_operation = FLAGS_SUB;
+    flag_operand1 = register1;
+    flag_operand2 = value;
+    flag_result = result;
 }
 void CPU::andFlags(uint8_t result) {
-    setZeroFlag(result == 0);
-    setSubtractFlag(false);
-    setHalfCarryFlag(true);
-    setCarryFlag(false);
+    flag_operation = FLAGS_AND;
+    flag_result = result;
 }
 void CPU::orFlags(uint8_t result) {
-    setZeroFlag(result == 0);
-    setSubtractFlag(false);
-    setHalfCarryFlag(false);
-    setCarryFlag(false);
+    flag_operation = FLAGS_OR;
+    flag_result = result;
+}
+
+// Builds F from the last recorded ALU operation. The low nibble of F is always zero.
+void CPU::materialiseFlags() {
+    bool zero = false, subtract = false, half_carry = false, carry = false;
+    switch (flag_operation) {
+        case FLAGS_NONE:
+            return;
+        case FLAGS_INC:
+            zero = flag_result == 0;
+            half_carry = (flag_result & 0x0F) == 0;
+            carry = flag_carry;
+            break;
+        case FLAGS_DEC:
+            zero = flag_result == 0;
+            subtract = true;
+            half_carry = (flag_result & 0x0F) == 0x0F;
+            carry = flag_carry;
+            break;
+        case FLAGS_ADD:
+            zero = (flag_result & 0xFF) == 0;
+            half_carry = ((flag_operand1 & 0x0F) + (flag_operand2 & 0x0F)) > 0x0F;
+            carry = flag_result > 0xFF;
+            break;
+        case FLAGS_SUB:
+            zero = flag_result == 0;
+            subtract = true;
+            half_carry = (flag_operand1 & 0x0F) < (flag_operand2 & 0x0F);
+            carry = flag_operand1 < flag_operand2;
+            break;
+        case FLAGS_AND:
+            zero = flag_result == 0;
+            half_carry = true;
+            break;
+        case FLAGS_OR:
+            zero = flag_result == 0;
+            break;
+    }
+    F = (zero << 7) | (subtract << 6) | (half_carry << 5) | (carry << 4);
+    flag_operation = FLAGS_NONE;
 }
 
 void CPU::RLC(uint8_t& register1) {
@@ -2,8 +2,19 @@
 
 #include "MMU/MMU.h"
 #include "Scheduler/scheduler.h"
+#include "CPU/block_cache.h"
+#include "CPU/jit.h"
+#include "CPU/opcodes.h"
+#include "Debug/watchpoints.h"
+#ifdef OPCODE_PROFILER
+#include "Profiler/opcode_profiler.h"
+#endif
+#ifdef SAMPLING_PROFILER
+#include "Profiler/sampling_profiler.h"
+#endif
 #include <cstdint>
 #include <array>
+#include <utility>
 #include <iostream>
 
 class CPU 
@@ -12,52 +23,39 @@ class CPU
         CPU(MMU *mmu, Scheduler *scheduler);
         void info();
 
-        // Instruction cycles
-        const uint8_t instructionCycles[256] = {
-            4, 12, 8, 8, 4, 4, 8, 4, 20, 8, 8, 8, 4, 4, 8, 4, // 0x00 - 0x0F
-            4, 12, 8, 8, 4, 4, 8, 4, 12, 8, 8, 8, 4, 4, 8, 4, // 0x10 - 0x1F
-            8, 12, 8, 8, 4, 4, 8, 4, 12, 8, 8, 8, 4, 4, 8, 4, // 0x20 - 0x2F
-            8, 12, 8, 8, 12, 12, 12, 4, 12, 8, 8, 8, 4, 4, 8, 4, // 0x30 - 0x3F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x40 - 0x4F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x50 - 0x5F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x60 - 0x6F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x70 - 0x7F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x80 - 0x8F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0x90 - 0x9F
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0xA0 - 0xAF
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0xB0 - 0xBF
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0xC0 - 0xCF
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0xD0 - 0xDF
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, // 0xE0 - 0xEF
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4  // 0xF0 - 0xFF
-        };
-        const uint8_t CBinstructionCycles[256] = {
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x00 - 0x0F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x10 - 0x1F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x20 - 0x2F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x30 - 0x3F
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8,  // 0x40 - 0x4F
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8,  // 0x50 - 0x5F
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8,  // 0x60 - 0x6F
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8,  // 0x70 - 0x7F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x80 - 0x8F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0x90 - 0x9F
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0xA0 - 0xAF
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0xB0 - 0xBF
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0xC0 - 0xCF
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0xD0 - 0xDF
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8,  // 0xE0 - 0xEF
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8   // 0xF0 - 0xFF
-        };
         bool halted, IME;
-        uint8_t A, B, C, D, E, H, L, F; // Registers
+        // Registers, addressable as 16-bit pairs or as their 8-bit halves. The low byte
+        // comes first, which assumes a little-endian host.
+        union { uint16_t AF; struct { uint8_t F, A; }; };
+        union { uint16_t BC; struct { uint8_t C, B; }; };
+        union { uint16_t DE; struct { uint8_t E, D; }; };
+        union { uint16_t HL; struct { uint8_t L, H; }; };
         uint16_t SP, PC;  // Stack Pointer & Program Counter
         int timer_cycles, divider_cycles; // Timer & Divider Cycles
 
         MMU* mmu;
         Scheduler* scheduler;
         uint8_t* memory;
+        BlockCache block_cache;
+        JIT jit;
+        Watchpoints watchpoints;
+        bool block_exit; // Set when the rest of the running block may no longer be mapped
+        long long busy_wait_cycles = 0; // Cycles skipped inside busy-wait loops
+        long long bulk_loop_cycles = 0; // Cycles of copy and fill loops run in bulk
+#ifdef OPCODE_PROFILER
+        OpcodeProfiler profiler;
+#endif
+#ifdef SAMPLING_PROFILER
+        SamplingProfiler sampler;
+#endif
 
+        uint8_t getFlags() {
+            if (flag_operation != FLAGS_NONE) {
+                materialiseFlags();
+            }
+            return F;
+        }
+        void setFlags(uint8_t value);
         bool getZeroFlag();
         bool getSubtractFlag();
         bool getHalfCarryFlag();
@@ -72,12 +70,59 @@ class CPU
         void handleInterrupts();
         bool checkInterrupts();
         void updateInterrupt(uint8_t interruptFlag, uint8_t pc);
-        void executeInstruction(uint8_t opcode);
-        void executeCBInstruction(uint8_t cb_opcode);
-        int getCycles(uint8_t opcode);
+        int step();
+        int skipBusyWait(const MicroOp *loop);
+        int runBulkLoop(const MicroOp *loop);
+        MicroOp decode(uint16_t address);
+        int fuse(MicroOp *ops, size_t count);
+        Handler flagless(uint8_t opcode) { return flaglessOpcodes[opcode]; }
+        int executeCBInstruction(uint8_t cb_opcode);
 
 
     private:
+        friend class JIT;
+        static int dispatch(CPU *cpu, uint8_t opcode) { return (cpu->*opcodes[opcode])(); }
+        int execute();
+
+        // Dispatch tables indexed by opcode, filled with the op/cb specialisations in CPU.cpp
+        static const Handler opcodes[256];
+        static const Handler CBopcodes[256];
+        uint16_t operand; // Immediate operand of the instruction being executed
+        template <uint8_t opcode> int op();
+        template <uint8_t opcode> int cb();
+
+        // Superinstructions, see fuse()
+        struct Fusion {
+            uint8_t opcodes[3];
+            uint8_t count;
+            Handler handler;
+        };
+        static const Fusion fusions[];
+        template <uint8_t first, uint8_t... rest> int fused();
+        template <uint8_t opcode, uint8_t... rest> int fusedNext(int cycles);
+        bool fusedBoundary(int cycles);
+
+        // Flag-free variants, see opNoFlags(); nullptr where there is none
+        static const std::array<Handler, 256> flaglessOpcodes;
+        template <uint8_t opcode> int opNoFlags();
+        template <uint8_t opcode> static constexpr Handler flaglessHandler();
+        template <size_t... opcode> static std::array<Handler, 256> flaglessTable(std::index_sequence<opcode...>);
+
+        // CB-prefix kernels, instantiated per (operation, bit, register index)
+        enum CBOperation { CB_RLC, CB_RRC, CB_RL, CB_RR, CB_SLA, CB_SRA, CB_SWAP, CB_SRL, CB_BIT, CB_RES, CB_SET };
+        template <CBOperation operation, uint8_t bit, uint8_t reg> int CBkernel();
+        template <CBOperation operation, uint8_t bit> void CBoperation(uint8_t& value);
+        template <uint8_t reg> uint8_t& registerByIndex();
+
+        // Lazy flags: the ALU helpers below only record their inputs, F is rebuilt
+        // from them when something reads a flag or sets one individually
+        enum FlagOperation : uint8_t { FLAGS_NONE, FLAGS_ADD, FLAGS_SUB, FLAGS_INC, FLAGS_DEC, FLAGS_AND, FLAGS_OR };
+        FlagOperation flag_operation;
+        uint8_t flag_operand1, flag_operand2;
+        uint16_t flag_result;
+        bool flag_carry; // Carry kept by INC/DEC
+        void materialiseFlags();
+
         void incrementFlags(uint8_t register1);
         void decrementFlags(uint8_t register1);
         void additionFlags(uint8_t register1, uint8_t value, uint16_t result);
@@ -0,0 +1,276 @@
+#include "block_cache.h"
+#include "CPU.h"
+#include "jit.h"
+
+#include <algorithm>
+
+// Whether the block ends in a JR NZ (or JR Z, if allowed) back to its own start
+static bool loopsToStart(const std::vector<MicroOp> &ops, uint16_t start, bool allow_z) {
+    const MicroOp &branch = ops.back();
+    if (branch.opcode != 0x20 && (!allow_z || branch.opcode != 0x28)) {
+        return false;
+    }
+    return (uint16_t)(branch.address + branch.length + (int8_t)branch.operand) == start;
+}
+
+// Cycles of one iteration of a loop block, with its closing JR taken
+static int iterationCycles(const std::vector<MicroOp> &ops) {
+    int cycles = OPCODES[ops.back().opcode].taken_cycles;
+    for (size_t i = 0; i + 1 < ops.size(); i++) {
+        cycles += ops[i].cycles;
+    }
+    return cycles;
+}
+
+// Recognises `LDH A, [STAT or LY]; CP n8 / AND n8 / BIT b, A; JR NZ/Z` loops that
+// branch back to their own start.
+static bool busyWait(const std::vector<MicroOp> &ops, uint16_t start) {
+    if (ops.size() != 3) {
+        return false;
+    }
+    const MicroOp &load = ops[0], &test = ops[1];
+    if (load.opcode != 0xF0 || (load.operand != 0x41 && load.operand != 0x44)) {
+        return false;
+    }
+    bool bit_test = test.opcode == 0xCB && (test.operand & 0xC7) == 0x47;
+    if (test.opcode != 0xFE && test.opcode != 0xE6 && !bit_test) {
+        return false;
+    }
+    return loopsToStart(ops, start, true);
+}
+
+// Recognises copy and fill loops that branch back to their own start:
+//   LD A, [HL+]; LD [DE], A; INC DE       copy from HL to DE
+//   LD A, [DE]; LD [HL+], A; INC DE       copy from DE to HL
+//   [XOR A | LD A, n8]; LD [HL+], A       fill from HL
+// each followed by a counter: DEC B or DEC C; JR NZ, or DEC BC; LD A, B; OR C
+// (or LD A, C; OR B); JR NZ. The 16-bit counter overwrites A, so a fill only
+// qualifies with it if the loop reloads A first.
+static LoopKind bulkLoop(const std::vector<MicroOp> &ops, uint16_t start) {
+    std::vector<uint8_t> opcodes;
+    for (const MicroOp &op : ops) {
+        opcodes.push_back(op.opcode);
+    }
+    size_t counter;
+    LoopKind kind;
+    bool reloads_a = opcodes[0] == 0xAF || opcodes[0] == 0x3E;
+    if (opcodes.size() >= 3 && ((opcodes[0] == 0x2A && opcodes[1] == 0x12) || (opcodes[0] == 0x1A && opcodes[1] == 0x22)) && opcodes[2] == 0x13) {
+        kind = LOOP_COPY;
+        counter = 3;
+    } else if (opcodes[0] == 0x22) {
+        kind = LOOP_FILL;
+        counter = 1;
+    } else if (reloads_a && opcodes.size() >= 2 && opcodes[1] == 0x22) {
+        kind = LOOP_FILL;
+        counter = 2;
+    } else {
+        return LOOP_NONE;
+    }
+
+    std::vector<uint8_t> rest(opcodes.begin() + counter, opcodes.end());
+    bool short_counter = rest == std::vector<uint8_t>{0x05, 0x20} || rest == std::vector<uint8_t>{0x0D, 0x20};
+    bool long_counter = rest == std::vector<uint8_t>{0x0B, 0x78, 0xB1, 0x20} || rest == std::vector<uint8_t>{0x0B, 0x79, 0xB0, 0x20};
+    if (long_counter && kind == LOOP_FILL && !reloads_a) {
+        return LOOP_NONE;
+    }
+    if (!(short_counter || long_counter) || !loopsToStart(ops, start, false)) {
+        return LOOP_NONE;
+    }
+    return kind;
+}
+
+// Whether the rest of the block might not run after op, so that other code sees the
+// flags it leaves: a bank switch, a write into the block or an interrupt being raised
+// or enabled. Only writes to known plain addresses are ruled out.
+static bool mayLeaveBlock(const MicroOp &op, uint16_t start, uint16_t end) {
+    const OpcodeInfo &info = OPCODES[op.opcode];
+    if (info.ends_block) {
+        return true;
+    }
+    if (!(info.memory & (MEM_WRITE | MEM_STACK))) {
+        return false;
+    }
+    if (op.opcode == 0xEA || op.opcode == 0x08) { // LD [a16], A / SP
+        return op.operand < 0x8000 || op.operand >= 0xFF00 || (op.operand + 1 >= start && op.operand < end);
+    }
+    if (op.opcode == 0xE0) { // LDH [a8], A, fine for HRAM below IE
+        return (op.operand & 0xFF) < 0x80 || (op.operand & 0xFF) == 0xFF;
+    }
+    return true;
+}
+
+// Backwards flag liveness over a block. Every flag is live at the end of the block
+// and after any op that might leave it early; an op none of whose written flags are
+// live switches to its flag-free variant, if it has one. An interrupt taken in
+// between can see stale flags only in the F it pushes with PUSH AF, which POP AF
+// restores before the block overwrites them anyway.
+static void dropDeadFlags(CPU *cpu, std::vector<MicroOp> &ops, uint16_t start, uint16_t end) {
+#ifdef DEBUG_TRACE
+    (void)cpu; (void)ops; (void)start; (void)end;
+    return; // The tracer logs F after every step
+#endif
+    const uint8_t all = FLAG_Z | FLAG_N | FLAG_H | FLAG_C;
+    uint8_t live = all;
+    for (size_t i = ops.size(); i-- > 0;) {
+        MicroOp &op = ops[i];
+        const OpcodeInfo &info = opcodeInfo(op.opcode, op.operand);
+        if (mayLeaveBlock(op, start, end)) {
+            live = all;
+        }
+        if (info.flags_written != 0 && (info.flags_written & live) == 0 && cpu->flagless(op.opcode) != nullptr) {
+            op.handler = cpu->flagless(op.opcode);
+        }
+        live = (live & ~info.flags_written) | info.flags_read;
+    }
+}
+
+BlockCache::BlockCache(CPU *cpu, MMU *mmu) {
+    this->cpu = cpu;
+    this->mmu = mmu;
+}
+
+// Returns the decoded instruction at address. Sequential execution inside the
+// current block is a single compare; anything else goes through the block map.
+const MicroOp& BlockCache::fetch(uint16_t address) {
+    if (current != nullptr && index < current->ops.size() && current->ops[index].address == address) {
+        return current->ops[index++];
+    }
+    if (!cacheable(address) || !keepable(address)) {
+        current = nullptr;
+        uncached = cpu->decode(address);
+        cpu->watchpoints.check(address, uncached.opcode, WATCH_EXECUTE);
+        return uncached;
+    }
+
+    uint32_t block_key = key(address);
+    auto it = blocks.find(block_key);
+    current = (it != blocks.end()) ? &it->second : &build(block_key, address);
+    index = 1;
+    if (jit != nullptr && current->ops[0].native == nullptr && ++current->executions == JIT::HOT_THRESHOLD) {
+        jit->compile(*current);
+    }
+    return current->ops[0];
+}
+
+// Called by the MMU for writes into a page that holds cached RAM code
+void BlockCache::invalidate(uint16_t address) {
+    std::vector<uint32_t> &keys = page_blocks[address >> 8];
+    for (size_t i = 0; i < keys.size();) {
+        Block &block = blocks[keys[i]];
+        if (block.start <= address && address < block.end) {
+            remove(keys[i]);
+        } else {
+            i++;
+        }
+    }
+}
+
+// Blocks are keyed by bank, so a switch only has to stop the current block from
+// running on into code that is no longer mapped. Translated blocks check
+// block_exit after each call for the same reason.
+void BlockCache::bank_switched() {
+    current = nullptr;
+    cpu->block_exit = true;
+}
+
+// Called by the MMU when an OAM DMA starts, so the rest of the current block goes
+// back through fetch, which checks keepable on every lookup
+void BlockCache::dma_started() {
+    current = nullptr;
+    cpu->block_exit = true;
+}
+
+void BlockCache::clear() {
+    blocks.clear();
+    for (int page = 0; page < 256; page++) {
+        if (!page_blocks[page].empty()) {
+            page_blocks[page].clear();
+            mmu->map_page(page);
+        }
+    }
+    current = nullptr;
+}
+
+// Outside HRAM, code fetched during OAM DMA may read the DMA's bytes, so it is
+// decoded afresh rather than run from a block. Pages with execute watchpoints are
+// never cached, so every instruction in them gets checked.
+bool BlockCache::keepable(uint16_t address) {
+    return !(mmu->dma_active() && address < 0xFF80) && !cpu->watchpoints.page_watched(address >> 8, WATCH_EXECUTE);
+}
+
+// Cartridge RAM and the I/O area are decoded on every execution
+bool BlockCache::cacheable(uint16_t address) {
+    return address < 0xA000 || (address >= 0xC000 && address < 0xFE00) || (address >= 0xFF80 && address < 0xFFFF);
+}
+
+uint32_t BlockCache::key(uint16_t address) {
+    int bank = 0;
+    if (address < 0x100 && !mmu->rom_disabled) {
+        bank = -1; // Boot ROM overlay
+    } else if (address < 0x8000) {
+        bank = mmu->cartridge->rom_bank(address);
+    }
+    return ((uint32_t)(bank + 1) << 16) | address;
+}
+
+BlockCache::Block& BlockCache::build(uint32_t block_key, uint16_t address) {
+    Block &block = blocks[block_key];
+    block.start = address;
+
+    // Never run past the end of the region the key's bank describes
+    uint32_t limit = 0x10000;
+    if (address < 0x100 && !mmu->rom_disabled) {
+        limit = 0x100;
+    } else if (address < 0x4000) {
+        limit = 0x4000;
+    } else if (address < 0x8000) {
+        limit = 0x8000;
+    }
+
+    uint32_t pc = address;
+    do {
+        MicroOp op = cpu->decode(pc);
+        block.ops.push_back(op);
+        pc += op.length;
+        if (OPCODES[op.opcode].ends_block) {
+            break;
+        }
+    } while (pc < limit && block.ops.size() < MAX_BLOCK_LENGTH && cacheable(pc) && !cpu->watchpoints.page_watched(pc >> 8, WATCH_EXECUTE));
+    block.end = std::min<uint32_t>(pc, 0xFFFF);
+    LoopKind loop = busyWait(block.ops, address) ? LOOP_BUSY_WAIT : bulkLoop(block.ops, address);
+    if (loop != LOOP_NONE) {
+        block.ops[0].loop_kind = loop;
+        block.ops[0].loop_cycles = iterationCycles(block.ops);
+    }
+    dropDeadFlags(cpu, block.ops, block.start, block.end);
+    for (size_t i = 0; i < block.ops.size();) {
+        i += std::max(cpu->fuse(&block.ops[i], block.ops.size() - i), 1);
+    }
+
+    if (address >= 0x8000) {
+        for (int page = block.start >> 8; page <= (block.end - 1) >> 8; page++) {
+            page_blocks[page].push_back(block_key);
+            if (page_blocks[page].size() == 1) {
+                mmu->map_page(page); // Writes here must now invalidate
+            }
+        }
+    }
+    return block;
+}
+
+void BlockCache::remove(uint32_t block_key) {
+    auto it = blocks.find(block_key);
+    Block &block = it->second;
+    for (int page = block.start >> 8; page <= (block.end - 1) >> 8; page++) {
+        std::vector<uint32_t> &keys = page_blocks[page];
+        keys.erase(std::remove(keys.begin(), keys.end(), block_key), keys.end());
+        if (keys.empty()) {
+            mmu->map_page(page);
+        }
+    }
+    if (current == &block) {
+        current = nullptr;
+        cpu->block_exit = true;
+    }
+    blocks.erase(it);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class CPU;
+class MMU;
+class JIT;
+struct JitBlock;
+
+typedef int (CPU::*Handler)();
+
+// Loops that make up a whole block and that the CPU can run many iterations of at once
+enum LoopKind : uint8_t { LOOP_NONE, LOOP_BUSY_WAIT, LOOP_COPY, LOOP_FILL };
+
+// A decoded instruction: its handler, immediate operand and base cycle cost,
+// so executing it needs no further opcode or operand fetches.
+struct MicroOp {
+    Handler handler;
+    uint16_t address;
+    uint16_t operand;
+    uint8_t opcode;
+    uint8_t length;
+    uint8_t cycles;
+    JitBlock *native = nullptr; // Set on the first op of a block the JIT has translated
+    uint8_t loop_cycles = 0;    // Set on the first op of a recognised loop, cycles per iteration
+    LoopKind loop_kind = LOOP_NONE;
+};
+
+// Straight-line runs of decoded instructions keyed by (ROM bank, address).
+// Blocks end at the first control flow instruction. Blocks in RAM are dropped when
+// a write lands inside them; bank switches select another key instead of flushing.
+// Common instruction sequences inside a block run as one superinstruction.
+class BlockCache {
+    public:
+        static constexpr int MAX_BLOCK_LENGTH = 32;
+
+        BlockCache(CPU *cpu, MMU *mmu);
+        const MicroOp& fetch(uint16_t address);
+        const MicroOp& next() { return current->ops[index++]; } // The op after the last fetch, for superinstructions
+        void invalidate(uint16_t address);
+        void bank_switched();
+        void dma_started();
+        void clear();
+        bool holds_code(uint16_t address) { return !page_blocks[address >> 8].empty(); }
+
+        struct Block {
+            uint16_t start;
+            uint16_t end;
+            int executions = 0;
+            std::vector<MicroOp> ops;
+        };
+
+        JIT *jit = nullptr; // Translates blocks once they get hot, when enabled
+
+    private:
+        CPU *cpu;
+        MMU *mmu;
+        std::unordered_map<uint32_t, Block> blocks;
+        std::vector<uint32_t> page_blocks[256]; // Keys of RAM blocks touching each page
+        Block *current = nullptr;
+        size_t index = 0;
+        MicroOp uncached;
+
+        bool cacheable(uint16_t address);
+        bool keepable(uint16_t address);
+        uint32_t key(uint16_t address);
+        Block& build(uint32_t key, uint16_t address);
+        void remove(uint32_t key);
+};
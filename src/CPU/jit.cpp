@@ -0,0 +1,290 @@
+#include "jit.h"
+#include "CPU.h"
+#include "PPU/PPU.h"
+
+#include <cstring>
+
+#if JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+// Register conventions inside a translated block:
+//   rbx  = CPU*
+//   r12d = cycles taken so far
+// Both are callee saved, so handler calls leave them alone.
+
+JIT::JIT(CPU *cpu) {
+    this->cpu = cpu;
+}
+
+JIT::~JIT() {
+    for (JitBlock *compiled : translated) {
+        delete compiled;
+    }
+#if JIT_SUPPORTED
+    if (code != nullptr) {
+        munmap(code, CODE_SIZE);
+    }
+#endif
+}
+
+// Maps the code buffer and hooks the JIT into the block cache. Returns false on
+// hosts without a backend, leaving the interpreter in charge.
+bool JIT::enable(bool verify) {
+#if JIT_SUPPORTED
+    if (code == nullptr) {
+        void *memory = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        code = (uint8_t*)memory;
+    }
+    this->verify = verify;
+    cpu->block_cache.jit = this;
+    return true;
+#else
+    (void)verify;
+    return false;
+#endif
+}
+
+// ROM blocks only: RAM code may modify itself, and I/O accesses want the scheduler
+// to be up to date, which it only is at block boundaries. So every memory access has
+// to be to an absolute address between 0x8000 and 0xFEFF; accesses through HL, BC,
+// DE or SP could reach I/O or MBC registers. Copy, fill and busy-wait loops are
+// left to the interpreter, which runs them in bulk.
+bool JIT::eligible(const BlockCache::Block &block) {
+    if (block.start >= 0x8000 || block.ops.size() < 2 || block.ops[0].loop_cycles != 0) {
+        return false;
+    }
+    for (const MicroOp &op : block.ops) {
+        const OpcodeInfo &info = opcodeInfo(op.opcode, op.operand);
+        if (info.memory & (MEM_STACK | MEM_HIGH)) {
+            return false;
+        }
+        if (info.memory & (MEM_READ | MEM_WRITE)) {
+            int last = op.operand + (op.opcode == 0x08 ? 1 : 0); // LD [n16], SP writes two bytes
+            if (info.operand != OPERAND_A16 || op.operand < 0x8000 || last >= 0xFF00) {
+                return false;
+            }
+        }
+        switch (op.opcode) {
+            case 0x10: // STOP
+            case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4: case 0xEB: // Invalid
+            case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+                return false;
+        }
+    }
+    return true;
+}
+
+// Ops that touch nothing but registers and have a fixed cost
+bool JIT::native(uint8_t opcode) {
+    if (opcode >= 0x40 && opcode < 0x80) { // LD r, r'
+        return (opcode & 0x07) != 6 && ((opcode >> 3) & 0x07) != 6;
+    }
+    switch (opcode) {
+        case 0x00: // NOP
+        case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x3E: // LD r, n8
+        case 0xAF: // XOR A, A
+            return true;
+    }
+    return false;
+}
+
+void JIT::compile(BlockCache::Block &block) {
+#if JIT_SUPPORTED
+    if (code == nullptr || !eligible(block)) {
+        return;
+    }
+
+    buffer.clear();
+    emit({0x53});                         // push rbx
+    emit({0x41, 0x54});                   // push r12
+    emit({0x48, 0x83, 0xEC, 0x08});       // sub rsp, 8
+    emit({0x48, 0x89, 0xFB});             // mov rbx, rdi
+    emit({0x45, 0x31, 0xE4});             // xor r12d, r12d
+    emit({0xC6, 0x83}); emit32(offset(&cpu->block_exit)); emit({0x00}); // mov byte [block_exit], 0
+
+    std::vector<size_t> exits;
+    for (const MicroOp &op : block.ops) {
+        if (native(op.opcode)) {
+            emit_native(op);
+        } else {
+            emit_call(op);
+            emit({0x80, 0xBB}); emit32(offset(&cpu->block_exit)); emit({0x00}); // cmp byte [block_exit], 0
+            emit({0x0F, 0x85});           // jne exit
+            exits.push_back(buffer.size());
+            emit32(0);
+        }
+    }
+    // A block cut short by its length limit falls through to the next address
+    if (native(block.ops.back().opcode)) {
+        emit({0x66, 0xC7, 0x83}); emit32(offset(&cpu->PC)); emit16(block.end); // mov word [PC], end
+    }
+
+    for (size_t exit : exits) {
+        int32_t rel = buffer.size() - (exit + 4);
+        std::memcpy(&buffer[exit], &rel, 4);
+    }
+    emit({0x44, 0x89, 0xE0});             // mov eax, r12d
+    emit({0x48, 0x83, 0xC4, 0x08});       // add rsp, 8
+    emit({0x41, 0x5C});                   // pop r12
+    emit({0x5B});                         // pop rbx
+    emit({0xC3});                         // ret
+
+    if (used + buffer.size() > CODE_SIZE) {
+        return; // Out of code space, the rest stays interpreted
+    }
+    uint8_t *target = code + used;
+    mprotect(code, CODE_SIZE, PROT_READ | PROT_WRITE);
+    std::memcpy(target, buffer.data(), buffer.size());
+    mprotect(code, CODE_SIZE, PROT_READ | PROT_EXEC);
+    used += (buffer.size() + 15) & ~(size_t)15;
+
+    JitBlock *compiled = new JitBlock{(NativeCode)target, &block};
+    translated.push_back(compiled);
+    block.ops[0].native = compiled;
+    compiled_blocks++;
+#else
+    (void)block;
+#endif
+}
+
+void JIT::emit_native(const MicroOp &op) {
+    uint8_t *regs[8] = {&cpu->B, &cpu->C, &cpu->D, &cpu->E, &cpu->H, &cpu->L, nullptr, &cpu->A};
+    uint8_t opcode = op.opcode;
+
+    if (opcode >= 0x40 && opcode < 0x80) {
+        emit({0x8A, 0x83}); emit32(offset(regs[opcode & 0x07]));        // mov al, [src]
+        emit({0x88, 0x83}); emit32(offset(regs[(opcode >> 3) & 0x07])); // mov [dst], al
+    } else if ((opcode & 0xC7) == 0x06) {
+        emit({0xC6, 0x83}); emit32(offset(regs[(opcode >> 3) & 0x07])); emit({(uint8_t)op.operand}); // mov byte [dst], n8
+    } else if (opcode == 0xAF) {
+        emit({0xC6, 0x83}); emit32(offset(&cpu->A)); emit({0x00}); // mov byte [A], 0
+        emit({0xC6, 0x83}); emit32(offset(&cpu->flag_operation)); emit({CPU::FLAGS_OR}); // record OR with result 0
+        emit({0x66, 0xC7, 0x83}); emit32(offset(&cpu->flag_result)); emit16(0);
+    }
+    emit({0x41, 0x81, 0xC4}); emit32(op.cycles); // add r12d, cycles
+}
+
+// Sets PC and the operand the way CPU::step would, then runs the interpreter handler
+void JIT::emit_call(const MicroOp &op) {
+    emit({0x66, 0xC7, 0x83}); emit32(offset(&cpu->operand)); emit16(op.operand);
+    emit({0x66, 0xC7, 0x83}); emit32(offset(&cpu->PC)); emit16(op.address + op.length);
+    emit({0x48, 0x89, 0xDF});             // mov rdi, rbx
+    emit({0xBE}); emit32(op.opcode);      // mov esi, opcode
+    emit({0x48, 0xB8}); emit64((uint64_t)(uintptr_t)&CPU::dispatch); // mov rax, dispatch
+    emit({0xFF, 0xD0});                   // call rax
+    emit({0x41, 0x01, 0xC4});             // add r12d, eax
+}
+
+int JIT::run(const JitBlock &compiled) {
+    if (!verify) {
+        return compiled.code(cpu);
+    }
+
+    // Run the block through the interpreter first, rewind, then run the native code
+    Snapshot before = capture();
+    int expected_cycles = interpret(*compiled.block);
+    Snapshot expected = capture();
+    restore(before);
+    int cycles = compiled.code(cpu);
+    Snapshot actual = capture();
+
+    if (cycles != expected_cycles || !same(expected, actual)) {
+        mismatches++;
+        std::cerr << std::hex << "JIT mismatch in block at 0x" << compiled.block->start
+                  << ": PC 0x" << actual.PC << " (expected 0x" << expected.PC << ")"
+                  << ", F 0x" << (int)actual.F << " (expected 0x" << (int)expected.F << ")"
+                  << std::dec << ", cycles " << cycles << " (expected " << expected_cycles << ")" << std::endl;
+    }
+    return cycles;
+}
+
+// Executes a block op by op with the same PC and exit rules as the translated code
+int JIT::interpret(const BlockCache::Block &block) {
+    int cycles = 0;
+    cpu->block_exit = false;
+    for (const MicroOp &op : block.ops) {
+        cpu->operand = op.operand;
+        cpu->PC = op.address + op.length;
+        cycles += CPU::dispatch(cpu, op.opcode); // op.handler may be a superinstruction
+        if (cpu->block_exit) {
+            break;
+        }
+    }
+    return cycles;
+}
+
+JIT::Snapshot JIT::capture() {
+    Snapshot snapshot;
+    snapshot.A = cpu->A; snapshot.B = cpu->B; snapshot.C = cpu->C; snapshot.D = cpu->D;
+    snapshot.E = cpu->E; snapshot.H = cpu->H; snapshot.L = cpu->L; snapshot.F = cpu->getFlags();
+    snapshot.SP = cpu->SP;
+    snapshot.PC = cpu->PC;
+    snapshot.IME = cpu->IME;
+    snapshot.halted = cpu->halted;
+    snapshot.mmu.reset(new MMU(*cpu->mmu));
+    Cartridge *cartridge = cpu->mmu->cartridge;
+    snapshot.mbc.reset(cartridge->mbc->clone());
+    if (cartridge->ram != nullptr) {
+        snapshot.ram.assign(cartridge->ram, cartridge->ram + cartridge->banks_ram * 0x2000);
+    }
+    snapshot.scheduler.reset(new Scheduler(*cpu->scheduler));
+    if (cpu->scheduler->ppu != nullptr) {
+        snapshot.ppu.reset(new PPU(*cpu->scheduler->ppu));
+    }
+    snapshot.watchpoints.reset(new Watchpoints(cpu->watchpoints));
+    return snapshot;
+}
+
+void JIT::restore(const Snapshot &snapshot) {
+    cpu->A = snapshot.A; cpu->B = snapshot.B; cpu->C = snapshot.C; cpu->D = snapshot.D;
+    cpu->E = snapshot.E; cpu->H = snapshot.H; cpu->L = snapshot.L; cpu->setFlags(snapshot.F);
+    cpu->SP = snapshot.SP;
+    cpu->PC = snapshot.PC;
+    cpu->IME = snapshot.IME;
+    cpu->halted = snapshot.halted;
+    *cpu->mmu = *snapshot.mmu;
+    Cartridge *cartridge = cpu->mmu->cartridge;
+    delete cartridge->mbc;
+    cartridge->mbc = snapshot.mbc->clone();
+    if (!snapshot.ram.empty()) {
+        std::memcpy(cartridge->ram, snapshot.ram.data(), snapshot.ram.size());
+    }
+    *cpu->scheduler = *snapshot.scheduler;
+    if (snapshot.ppu != nullptr) {
+        *cpu->scheduler->ppu = *snapshot.ppu;
+    }
+    cpu->watchpoints = *snapshot.watchpoints;
+}
+
+bool JIT::same(const Snapshot &a, const Snapshot &b) {
+    return a.A == b.A && a.B == b.B && a.C == b.C && a.D == b.D && a.E == b.E && a.H == b.H && a.L == b.L && a.F == b.F &&
+           a.SP == b.SP && a.PC == b.PC && a.IME == b.IME && a.halted == b.halted &&
+           std::memcmp(a.mmu->memory, b.mmu->memory, sizeof(a.mmu->memory)) == 0 && a.ram == b.ram;
+}
+
+void JIT::emit(std::initializer_list<uint8_t> bytes) {
+    buffer.insert(buffer.end(), bytes);
+}
+
+void JIT::emit16(uint16_t value) {
+    emit({(uint8_t)value, (uint8_t)(value >> 8)});
+}
+
+void JIT::emit32(uint32_t value) {
+    emit16(value);
+    emit16(value >> 16);
+}
+
+void JIT::emit64(uint64_t value) {
+    emit32(value);
+    emit32(value >> 32);
+}
+
+// Displacement of a CPU member from the CPU* held in rbx
+int32_t JIT::offset(const void *field) {
+    return (const uint8_t*)field - (const uint8_t*)cpu;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CPU/block_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CPU;
+class MBC;
+class MMU;
+class PPU;
+class Scheduler;
+class Watchpoints;
+
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_SUPPORTED 1
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+typedef int (*NativeCode)(CPU *cpu);
+
+// Native code for one block plus the decoded ops it was translated from
+struct JitBlock {
+    NativeCode code;
+    const BlockCache::Block *block;
+};
+
+// Translates hot ROM blocks to x86-64. Register moves, immediate loads and XOR A are
+// emitted inline; every other instruction calls its interpreter handler with PC and
+// the operand already set up. Cycles are summed in the block and handed back at the
+// exit, so the Scheduler and PPU still see the same totals, one sync per block.
+class JIT {
+    public:
+        static constexpr int HOT_THRESHOLD = 16;
+        static constexpr size_t CODE_SIZE = 16 << 20;
+
+        JIT(CPU *cpu);
+        ~JIT();
+        bool enable(bool verify);
+        void compile(BlockCache::Block &block);
+        int run(const JitBlock &compiled);
+
+        bool verify = false;
+        long long compiled_blocks = 0;
+        long long mismatches = 0;
+
+    private:
+        // Everything a block could change, so the interpreter run leaves no trace
+        struct Snapshot {
+            uint8_t A, B, C, D, E, H, L, F;
+            uint16_t SP, PC;
+            bool IME, halted;
+            std::unique_ptr<MMU> mmu;
+            std::unique_ptr<MBC> mbc;
+            std::vector<uint8_t> ram;
+            std::unique_ptr<Scheduler> scheduler;
+            std::unique_ptr<PPU> ppu;
+            std::unique_ptr<Watchpoints> watchpoints;
+        };
+
+        CPU *cpu;
+        uint8_t *code = nullptr;
+        size_t used = 0;
+        std::vector<uint8_t> buffer;
+        std::vector<JitBlock*> translated;
+
+        bool eligible(const BlockCache::Block &block);
+        bool native(uint8_t opcode);
+        void emit_native(const MicroOp &op);
+        void emit_call(const MicroOp &op);
+        int interpret(const BlockCache::Block &block);
+        Snapshot capture();
+        void restore(const Snapshot &snapshot);
+        bool same(const Snapshot &a, const Snapshot &b);
+
+        void emit(std::initializer_list<uint8_t> bytes);
+        void emit16(uint16_t value);
+        void emit32(uint32_t value);
+        void emit64(uint64_t value);
+        int32_t offset(const void *field);
+};
@@ -0,0 +1,51 @@
+#include "opcodes.h"
+
+#include <cstdio>
+
+// Formats one instruction in the syntax of the mnemonic table, substituting the
+// operand for its placeholder. Relative jumps show their target address.
+std::string disassemble(uint16_t address, uint8_t opcode, uint16_t operand) {
+    const OpcodeInfo &info = opcodeInfo(opcode, operand);
+    std::string text = info.mnemonic;
+    char value[8];
+    const char *placeholder = nullptr;
+    switch (info.operand) {
+        case OPERAND_N8:
+            placeholder = "n8";
+            std::snprintf(value, sizeof(value), "$%02X", operand & 0xFF);
+            break;
+        case OPERAND_N16:
+            placeholder = "n16";
+            std::snprintf(value, sizeof(value), "$%04X", operand);
+            break;
+        case OPERAND_E8:
+            placeholder = "e8";
+            if (opcode == 0x18 || (opcode & 0xE7) == 0x20) { // JR
+                std::snprintf(value, sizeof(value), "$%04X", (uint16_t)(address + info.length + (int8_t)operand));
+            } else {
+                std::snprintf(value, sizeof(value), "%d", (int8_t)operand);
+            }
+            break;
+        case OPERAND_A8:
+            placeholder = "a8";
+            std::snprintf(value, sizeof(value), "$FF%02X", operand & 0xFF);
+            break;
+        case OPERAND_A16:
+            placeholder = "a16";
+            std::snprintf(value, sizeof(value), "$%04X", operand);
+            break;
+        default:
+            break;
+    }
+    if (placeholder != nullptr) {
+        size_t position = text.find(placeholder);
+        if (position != std::string::npos) {
+            text.replace(position, std::string(placeholder).size(), value);
+        }
+        position = text.find("+ -"); // SP + e8 with a negative offset
+        if (position != std::string::npos) {
+            text.replace(position, 3, "- ");
+        }
+    }
+    return text;
+}
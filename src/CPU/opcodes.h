@@ -0,0 +1,569 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Everything the emulator knows about an instruction without executing it, one entry
+// per opcode. The decoder takes lengths and cycle costs from here, the block cache
+// its block boundaries and the disassembler the mnemonics, so they cannot disagree.
+
+enum OperandKind : uint8_t {
+    OPERAND_NONE,
+    OPERAND_N8,  // Immediate byte
+    OPERAND_N16, // Immediate word
+    OPERAND_E8,  // Signed byte, relative to the next instruction for JR
+    OPERAND_A8,  // Byte offset into 0xFF00 - 0xFFFF
+    OPERAND_A16, // Absolute address
+    OPERAND_CB,  // Opcode of a CB-prefixed instruction
+};
+
+// Flags as laid out in F
+constexpr uint8_t FLAG_Z = 0x80;
+constexpr uint8_t FLAG_N = 0x40;
+constexpr uint8_t FLAG_H = 0x20;
+constexpr uint8_t FLAG_C = 0x10;
+
+// Memory access classes, combined as bits
+constexpr uint8_t MEM_NONE = 0;
+constexpr uint8_t MEM_READ = 1 << 0;
+constexpr uint8_t MEM_WRITE = 1 << 1;
+constexpr uint8_t MEM_STACK = 1 << 2; // Pushes or pops through SP
+constexpr uint8_t MEM_HIGH = 1 << 3;  // Goes to 0xFF00 - 0xFFFF, i.e. I/O registers or HRAM
+
+struct OpcodeInfo {
+    const char *mnemonic;  // Operands named after their OperandKind, e.g. "LD A, [a16]"
+    uint8_t length;        // Bytes including the opcode (and the CB prefix)
+    uint8_t cycles;        // Cost, or the not-taken cost of a conditional branch
+    uint8_t taken_cycles;  // Cost of a taken conditional branch, otherwise cycles
+    OperandKind operand;
+    uint8_t flags_read;    // FLAG_ bits the instruction depends on
+    uint8_t flags_written; // FLAG_ bits it sets, resets or computes
+    uint8_t memory;        // MEM_ bits
+    bool ends_block;       // Can continue anywhere but the next instruction
+};
+
+inline constexpr OpcodeInfo OPCODES[256] = {
+    {"NOP", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x00
+    {"LD BC, n16", 3, 12, 12, OPERAND_N16, 0, 0, MEM_NONE, false}, // 0x01
+    {"LD [BC], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x02
+    {"INC BC", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x03
+    {"INC B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x04
+    {"DEC B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x05
+    {"LD B, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x06
+    {"RLCA", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x07
+    {"LD [a16], SP", 3, 20, 20, OPERAND_A16, 0, 0, MEM_WRITE, false}, // 0x08
+    {"ADD HL, BC", 1, 8, 8, OPERAND_NONE, 0, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x09
+    {"LD A, [BC]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x0A
+    {"DEC BC", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x0B
+    {"INC C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x0C
+    {"DEC C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x0D
+    {"LD C, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x0E
+    {"RRCA", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0F
+    {"STOP", 2, 4, 4, OPERAND_N8, 0, 0, MEM_NONE, true}, // 0x10
+    {"LD DE, n16", 3, 12, 12, OPERAND_N16, 0, 0, MEM_NONE, false}, // 0x11
+    {"LD [DE], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x12
+    {"INC DE", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x13
+    {"INC D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x14
+    {"DEC D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x15
+    {"LD D, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x16
+    {"RLA", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x17
+    {"JR e8", 2, 12, 12, OPERAND_E8, 0, 0, MEM_NONE, true}, // 0x18
+    {"ADD HL, DE", 1, 8, 8, OPERAND_NONE, 0, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x19
+    {"LD A, [DE]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x1A
+    {"DEC DE", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x1B
+    {"INC E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x1C
+    {"DEC E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x1D
+    {"LD E, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x1E
+    {"RRA", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1F
+    {"JR NZ, e8", 2, 8, 12, OPERAND_E8, FLAG_Z, 0, MEM_NONE, true}, // 0x20
+    {"LD HL, n16", 3, 12, 12, OPERAND_N16, 0, 0, MEM_NONE, false}, // 0x21
+    {"LD [HL+], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x22
+    {"INC HL", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x23
+    {"INC H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x24
+    {"DEC H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x25
+    {"LD H, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x26
+    {"DAA", 1, 4, 4, OPERAND_NONE, FLAG_N | FLAG_H | FLAG_C, FLAG_Z | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x27
+    {"JR Z, e8", 2, 8, 12, OPERAND_E8, FLAG_Z, 0, MEM_NONE, true}, // 0x28
+    {"ADD HL, HL", 1, 8, 8, OPERAND_NONE, 0, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x29
+    {"LD A, [HL+]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x2A
+    {"DEC HL", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x2B
+    {"INC L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x2C
+    {"DEC L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x2D
+    {"LD L, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x2E
+    {"CPL", 1, 4, 4, OPERAND_NONE, 0, FLAG_N | FLAG_H, MEM_NONE, false}, // 0x2F
+    {"JR NC, e8", 2, 8, 12, OPERAND_E8, FLAG_C, 0, MEM_NONE, true}, // 0x30
+    {"LD SP, n16", 3, 12, 12, OPERAND_N16, 0, 0, MEM_NONE, false}, // 0x31
+    {"LD [HL-], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x32
+    {"INC SP", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x33
+    {"INC [HL]", 1, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ | MEM_WRITE, false}, // 0x34
+    {"DEC [HL]", 1, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ | MEM_WRITE, false}, // 0x35
+    {"LD [HL], n8", 2, 12, 12, OPERAND_N8, 0, 0, MEM_WRITE, false}, // 0x36
+    {"SCF", 1, 4, 4, OPERAND_NONE, 0, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x37
+    {"JR C, e8", 2, 8, 12, OPERAND_E8, FLAG_C, 0, MEM_NONE, true}, // 0x38
+    {"ADD HL, SP", 1, 8, 8, OPERAND_NONE, 0, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x39
+    {"LD A, [HL-]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x3A
+    {"DEC SP", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x3B
+    {"INC A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x3C
+    {"DEC A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x3D
+    {"LD A, n8", 2, 8, 8, OPERAND_N8, 0, 0, MEM_NONE, false}, // 0x3E
+    {"CCF", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3F
+    {"LD B, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x40
+    {"LD B, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x41
+    {"LD B, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x42
+    {"LD B, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x43
+    {"LD B, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x44
+    {"LD B, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x45
+    {"LD B, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x46
+    {"LD B, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x47
+    {"LD C, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x48
+    {"LD C, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x49
+    {"LD C, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x4A
+    {"LD C, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x4B
+    {"LD C, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x4C
+    {"LD C, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x4D
+    {"LD C, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x4E
+    {"LD C, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x4F
+    {"LD D, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x50
+    {"LD D, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x51
+    {"LD D, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x52
+    {"LD D, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x53
+    {"LD D, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x54
+    {"LD D, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x55
+    {"LD D, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x56
+    {"LD D, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x57
+    {"LD E, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x58
+    {"LD E, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x59
+    {"LD E, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x5A
+    {"LD E, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x5B
+    {"LD E, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x5C
+    {"LD E, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x5D
+    {"LD E, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x5E
+    {"LD E, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x5F
+    {"LD H, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x60
+    {"LD H, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x61
+    {"LD H, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x62
+    {"LD H, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x63
+    {"LD H, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x64
+    {"LD H, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x65
+    {"LD H, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x66
+    {"LD H, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x67
+    {"LD L, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x68
+    {"LD L, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x69
+    {"LD L, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x6A
+    {"LD L, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x6B
+    {"LD L, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x6C
+    {"LD L, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x6D
+    {"LD L, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x6E
+    {"LD L, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x6F
+    {"LD [HL], B", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x70
+    {"LD [HL], C", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x71
+    {"LD [HL], D", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x72
+    {"LD [HL], E", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x73
+    {"LD [HL], H", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x74
+    {"LD [HL], L", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x75
+    {"HALT", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, true}, // 0x76
+    {"LD [HL], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE, false}, // 0x77
+    {"LD A, B", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x78
+    {"LD A, C", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x79
+    {"LD A, D", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x7A
+    {"LD A, E", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x7B
+    {"LD A, H", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x7C
+    {"LD A, L", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x7D
+    {"LD A, [HL]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ, false}, // 0x7E
+    {"LD A, A", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x7F
+    {"ADD A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x80
+    {"ADD A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x81
+    {"ADD A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x82
+    {"ADD A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x83
+    {"ADD A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x84
+    {"ADD A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x85
+    {"ADD A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0x86
+    {"ADD A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x87
+    {"ADC A, B", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x88
+    {"ADC A, C", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x89
+    {"ADC A, D", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x8A
+    {"ADC A, E", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x8B
+    {"ADC A, H", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x8C
+    {"ADC A, L", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x8D
+    {"ADC A, [HL]", 1, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0x8E
+    {"ADC A, A", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x8F
+    {"SUB A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x90
+    {"SUB A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x91
+    {"SUB A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x92
+    {"SUB A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x93
+    {"SUB A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x94
+    {"SUB A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x95
+    {"SUB A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0x96
+    {"SUB A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x97
+    {"SBC A, B", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x98
+    {"SBC A, C", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x99
+    {"SBC A, D", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x9A
+    {"SBC A, E", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x9B
+    {"SBC A, H", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x9C
+    {"SBC A, L", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x9D
+    {"SBC A, [HL]", 1, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0x9E
+    {"SBC A, A", 1, 4, 4, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x9F
+    {"AND A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA0
+    {"AND A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA1
+    {"AND A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA2
+    {"AND A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA3
+    {"AND A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA4
+    {"AND A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA5
+    {"AND A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0xA6
+    {"AND A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA7
+    {"XOR A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA8
+    {"XOR A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xA9
+    {"XOR A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xAA
+    {"XOR A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xAB
+    {"XOR A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xAC
+    {"XOR A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xAD
+    {"XOR A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0xAE
+    {"XOR A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xAF
+    {"OR A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB0
+    {"OR A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB1
+    {"OR A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB2
+    {"OR A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB3
+    {"OR A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB4
+    {"OR A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB5
+    {"OR A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0xB6
+    {"OR A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB7
+    {"CP A, B", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB8
+    {"CP A, C", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xB9
+    {"CP A, D", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xBA
+    {"CP A, E", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xBB
+    {"CP A, H", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xBC
+    {"CP A, L", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xBD
+    {"CP A, [HL]", 1, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ, false}, // 0xBE
+    {"CP A, A", 1, 4, 4, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xBF
+    {"RET NZ", 1, 8, 20, OPERAND_NONE, FLAG_Z, 0, MEM_STACK, true}, // 0xC0
+    {"POP BC", 1, 12, 12, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xC1
+    {"JP NZ, a16", 3, 12, 16, OPERAND_A16, FLAG_Z, 0, MEM_NONE, true}, // 0xC2
+    {"JP a16", 3, 16, 16, OPERAND_A16, 0, 0, MEM_NONE, true}, // 0xC3
+    {"CALL NZ, a16", 3, 12, 24, OPERAND_A16, FLAG_Z, 0, MEM_STACK, true}, // 0xC4
+    {"PUSH BC", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xC5
+    {"ADD A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xC6
+    {"RST $00", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xC7
+    {"RET Z", 1, 8, 20, OPERAND_NONE, FLAG_Z, 0, MEM_STACK, true}, // 0xC8
+    {"RET", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xC9
+    {"JP Z, a16", 3, 12, 16, OPERAND_A16, FLAG_Z, 0, MEM_NONE, true}, // 0xCA
+    {"PREFIX", 2, 4, 4, OPERAND_CB, 0, 0, MEM_NONE, false}, // 0xCB
+    {"CALL Z, a16", 3, 12, 24, OPERAND_A16, FLAG_Z, 0, MEM_STACK, true}, // 0xCC
+    {"CALL a16", 3, 24, 24, OPERAND_A16, 0, 0, MEM_STACK, true}, // 0xCD
+    {"ADC A, n8", 2, 8, 8, OPERAND_N8, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xCE
+    {"RST $08", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xCF
+    {"RET NC", 1, 8, 20, OPERAND_NONE, FLAG_C, 0, MEM_STACK, true}, // 0xD0
+    {"POP DE", 1, 12, 12, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xD1
+    {"JP NC, a16", 3, 12, 16, OPERAND_A16, FLAG_C, 0, MEM_NONE, true}, // 0xD2
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD3
+    {"CALL NC, a16", 3, 12, 24, OPERAND_A16, FLAG_C, 0, MEM_STACK, true}, // 0xD4
+    {"PUSH DE", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xD5
+    {"SUB A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xD6
+    {"RST $10", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xD7
+    {"RET C", 1, 8, 20, OPERAND_NONE, FLAG_C, 0, MEM_STACK, true}, // 0xD8
+    {"RETI", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xD9
+    {"JP C, a16", 3, 12, 16, OPERAND_A16, FLAG_C, 0, MEM_NONE, true}, // 0xDA
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDB
+    {"CALL C, a16", 3, 12, 24, OPERAND_A16, FLAG_C, 0, MEM_STACK, true}, // 0xDC
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDD
+    {"SBC A, n8", 2, 8, 8, OPERAND_N8, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xDE
+    {"RST $18", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xDF
+    {"LDH [a8], A", 2, 12, 12, OPERAND_A8, 0, 0, MEM_WRITE | MEM_HIGH, false}, // 0xE0
+    {"POP HL", 1, 12, 12, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xE1
+    {"LD [C], A", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_WRITE | MEM_HIGH, false}, // 0xE2
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE3
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE4
+    {"PUSH HL", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, false}, // 0xE5
+    {"AND A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xE6
+    {"RST $20", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xE7
+    {"ADD SP, e8", 2, 16, 16, OPERAND_E8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xE8
+    {"JP HL", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, true}, // 0xE9
+    {"LD [a16], A", 3, 16, 16, OPERAND_A16, 0, 0, MEM_WRITE, false}, // 0xEA
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEB
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEC
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xED
+    {"XOR A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xEE
+    {"RST $28", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xEF
+    {"LDH A, [a8]", 2, 12, 12, OPERAND_A8, 0, 0, MEM_READ | MEM_HIGH, false}, // 0xF0
+    {"POP AF", 1, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_STACK, false}, // 0xF1
+    {"LD A, [C]", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_READ | MEM_HIGH, false}, // 0xF2
+    {"DI", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF3
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF4
+    {"PUSH AF", 1, 16, 16, OPERAND_NONE, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, 0, MEM_STACK, false}, // 0xF5
+    {"OR A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xF6
+    {"RST $30", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xF7
+    {"LD HL, SP + e8", 2, 12, 12, OPERAND_E8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xF8
+    {"LD SP, HL", 1, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF9
+    {"LD A, [a16]", 3, 16, 16, OPERAND_A16, 0, 0, MEM_READ, false}, // 0xFA
+    {"EI", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFB
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFC
+    {"INVALID", 1, 4, 4, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFD
+    {"CP A, n8", 2, 8, 8, OPERAND_N8, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0xFE
+    {"RST $38", 1, 16, 16, OPERAND_NONE, 0, 0, MEM_STACK, true}, // 0xFF
+};
+
+// Cycles include the prefix
+inline constexpr OpcodeInfo CB_OPCODES[256] = {
+    {"RLC B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x00
+    {"RLC C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x01
+    {"RLC D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x02
+    {"RLC E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x03
+    {"RLC H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x04
+    {"RLC L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x05
+    {"RLC [HL]", 2, 16, 16, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x06
+    {"RLC A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x07
+    {"RRC B", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x08
+    {"RRC C", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x09
+    {"RRC D", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0A
+    {"RRC E", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0B
+    {"RRC H", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0C
+    {"RRC L", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0D
+    {"RRC [HL]", 2, 16, 16, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x0E
+    {"RRC A", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x0F
+    {"RL B", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x10
+    {"RL C", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x11
+    {"RL D", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x12
+    {"RL E", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x13
+    {"RL H", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x14
+    {"RL L", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x15
+    {"RL [HL]", 2, 16, 16, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x16
+    {"RL A", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x17
+    {"RR B", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x18
+    {"RR C", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x19
+    {"RR D", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1A
+    {"RR E", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1B
+    {"RR H", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1C
+    {"RR L", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1D
+    {"RR [HL]", 2, 16, 16, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x1E
+    {"RR A", 2, 8, 8, OPERAND_NONE, FLAG_C, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x1F
+    {"SLA B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x20
+    {"SLA C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x21
+    {"SLA D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x22
+    {"SLA E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x23
+    {"SLA H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x24
+    {"SLA L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x25
+    {"SLA [HL]", 2, 16, 16, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x26
+    {"SLA A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x27
+    {"SRA B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x28
+    {"SRA C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x29
+    {"SRA D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x2A
+    {"SRA E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x2B
+    {"SRA H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x2C
+    {"SRA L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x2D
+    {"SRA [HL]", 2, 16, 16, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x2E
+    {"SRA A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x2F
+    {"SWAP B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x30
+    {"SWAP C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x31
+    {"SWAP D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x32
+    {"SWAP E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x33
+    {"SWAP H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x34
+    {"SWAP L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x35
+    {"SWAP [HL]", 2, 16, 16, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x36
+    {"SWAP A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x37
+    {"SRL B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x38
+    {"SRL C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x39
+    {"SRL D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3A
+    {"SRL E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3B
+    {"SRL H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3C
+    {"SRL L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3D
+    {"SRL [HL]", 2, 16, 16, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_READ | MEM_WRITE, false}, // 0x3E
+    {"SRL A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H | FLAG_C, MEM_NONE, false}, // 0x3F
+    {"BIT 0, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x40
+    {"BIT 0, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x41
+    {"BIT 0, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x42
+    {"BIT 0, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x43
+    {"BIT 0, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x44
+    {"BIT 0, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x45
+    {"BIT 0, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x46
+    {"BIT 0, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x47
+    {"BIT 1, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x48
+    {"BIT 1, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x49
+    {"BIT 1, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x4A
+    {"BIT 1, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x4B
+    {"BIT 1, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x4C
+    {"BIT 1, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x4D
+    {"BIT 1, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x4E
+    {"BIT 1, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x4F
+    {"BIT 2, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x50
+    {"BIT 2, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x51
+    {"BIT 2, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x52
+    {"BIT 2, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x53
+    {"BIT 2, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x54
+    {"BIT 2, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x55
+    {"BIT 2, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x56
+    {"BIT 2, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x57
+    {"BIT 3, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x58
+    {"BIT 3, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x59
+    {"BIT 3, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x5A
+    {"BIT 3, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x5B
+    {"BIT 3, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x5C
+    {"BIT 3, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x5D
+    {"BIT 3, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x5E
+    {"BIT 3, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x5F
+    {"BIT 4, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x60
+    {"BIT 4, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x61
+    {"BIT 4, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x62
+    {"BIT 4, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x63
+    {"BIT 4, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x64
+    {"BIT 4, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x65
+    {"BIT 4, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x66
+    {"BIT 4, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x67
+    {"BIT 5, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x68
+    {"BIT 5, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x69
+    {"BIT 5, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x6A
+    {"BIT 5, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x6B
+    {"BIT 5, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x6C
+    {"BIT 5, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x6D
+    {"BIT 5, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x6E
+    {"BIT 5, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x6F
+    {"BIT 6, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x70
+    {"BIT 6, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x71
+    {"BIT 6, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x72
+    {"BIT 6, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x73
+    {"BIT 6, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x74
+    {"BIT 6, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x75
+    {"BIT 6, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x76
+    {"BIT 6, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x77
+    {"BIT 7, B", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x78
+    {"BIT 7, C", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x79
+    {"BIT 7, D", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x7A
+    {"BIT 7, E", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x7B
+    {"BIT 7, H", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x7C
+    {"BIT 7, L", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x7D
+    {"BIT 7, [HL]", 2, 12, 12, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_READ, false}, // 0x7E
+    {"BIT 7, A", 2, 8, 8, OPERAND_NONE, 0, FLAG_Z | FLAG_N | FLAG_H, MEM_NONE, false}, // 0x7F
+    {"RES 0, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x80
+    {"RES 0, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x81
+    {"RES 0, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x82
+    {"RES 0, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x83
+    {"RES 0, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x84
+    {"RES 0, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x85
+    {"RES 0, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0x86
+    {"RES 0, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x87
+    {"RES 1, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x88
+    {"RES 1, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x89
+    {"RES 1, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x8A
+    {"RES 1, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x8B
+    {"RES 1, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x8C
+    {"RES 1, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x8D
+    {"RES 1, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0x8E
+    {"RES 1, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x8F
+    {"RES 2, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x90
+    {"RES 2, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x91
+    {"RES 2, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x92
+    {"RES 2, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x93
+    {"RES 2, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x94
+    {"RES 2, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x95
+    {"RES 2, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0x96
+    {"RES 2, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x97
+    {"RES 3, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x98
+    {"RES 3, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x99
+    {"RES 3, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x9A
+    {"RES 3, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x9B
+    {"RES 3, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x9C
+    {"RES 3, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x9D
+    {"RES 3, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0x9E
+    {"RES 3, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0x9F
+    {"RES 4, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA0
+    {"RES 4, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA1
+    {"RES 4, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA2
+    {"RES 4, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA3
+    {"RES 4, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA4
+    {"RES 4, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA5
+    {"RES 4, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xA6
+    {"RES 4, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA7
+    {"RES 5, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA8
+    {"RES 5, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xA9
+    {"RES 5, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xAA
+    {"RES 5, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xAB
+    {"RES 5, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xAC
+    {"RES 5, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xAD
+    {"RES 5, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xAE
+    {"RES 5, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xAF
+    {"RES 6, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB0
+    {"RES 6, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB1
+    {"RES 6, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB2
+    {"RES 6, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB3
+    {"RES 6, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB4
+    {"RES 6, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB5
+    {"RES 6, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xB6
+    {"RES 6, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB7
+    {"RES 7, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB8
+    {"RES 7, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xB9
+    {"RES 7, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xBA
+    {"RES 7, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xBB
+    {"RES 7, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xBC
+    {"RES 7, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xBD
+    {"RES 7, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xBE
+    {"RES 7, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xBF
+    {"SET 0, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC0
+    {"SET 0, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC1
+    {"SET 0, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC2
+    {"SET 0, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC3
+    {"SET 0, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC4
+    {"SET 0, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC5
+    {"SET 0, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xC6
+    {"SET 0, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC7
+    {"SET 1, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC8
+    {"SET 1, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xC9
+    {"SET 1, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xCA
+    {"SET 1, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xCB
+    {"SET 1, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xCC
+    {"SET 1, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xCD
+    {"SET 1, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xCE
+    {"SET 1, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xCF
+    {"SET 2, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD0
+    {"SET 2, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD1
+    {"SET 2, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD2
+    {"SET 2, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD3
+    {"SET 2, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD4
+    {"SET 2, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD5
+    {"SET 2, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xD6
+    {"SET 2, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD7
+    {"SET 3, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD8
+    {"SET 3, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xD9
+    {"SET 3, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDA
+    {"SET 3, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDB
+    {"SET 3, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDC
+    {"SET 3, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDD
+    {"SET 3, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xDE
+    {"SET 3, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xDF
+    {"SET 4, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE0
+    {"SET 4, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE1
+    {"SET 4, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE2
+    {"SET 4, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE3
+    {"SET 4, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE4
+    {"SET 4, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE5
+    {"SET 4, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xE6
+    {"SET 4, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE7
+    {"SET 5, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE8
+    {"SET 5, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xE9
+    {"SET 5, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEA
+    {"SET 5, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEB
+    {"SET 5, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEC
+    {"SET 5, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xED
+    {"SET 5, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xEE
+    {"SET 5, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xEF
+    {"SET 6, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF0
+    {"SET 6, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF1
+    {"SET 6, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF2
+    {"SET 6, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF3
+    {"SET 6, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF4
+    {"SET 6, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF5
+    {"SET 6, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xF6
+    {"SET 6, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF7
+    {"SET 7, B", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF8
+    {"SET 7, C", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xF9
+    {"SET 7, D", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFA
+    {"SET 7, E", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFB
+    {"SET 7, H", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFC
+    {"SET 7, L", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFD
+    {"SET 7, [HL]", 2, 16, 16, OPERAND_NONE, 0, 0, MEM_READ | MEM_WRITE, false}, // 0xFE
+    {"SET 7, A", 2, 8, 8, OPERAND_NONE, 0, 0, MEM_NONE, false}, // 0xFF
+};
+
+// Info for the instruction starting with opcode, looking through the CB prefix
+constexpr const OpcodeInfo& opcodeInfo(uint8_t opcode, uint8_t cb_opcode) {
+    return (opcode == 0xCB) ? CB_OPCODES[cb_opcode] : OPCODES[opcode];
+}
+
+std::string disassemble(uint16_t address, uint8_t opcode, uint16_t operand);
@@ -52,19 +52,19 @@ void Cartridge::load_rom(std::string location) {
             mbc = new MBC0(memory, ram);
             break;
         } case 0x01: {
-            mbc = new MBC1(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC1(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x02: {
-            mbc = new MBC1(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC1(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x03: {
-            mbc = new MBC1(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC1(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x05: {
-            mbc = new MBC2(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC2(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x06: {
-            mbc = new MBC2(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC2(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x08: {
             mbc = new MBC0(memory, ram);
@@ -73,37 +73,37 @@ void Cartridge::load_rom(std::string location) {
             mbc = new MBC0(memory, ram);
             break;
         } case 0x0F: {
-            mbc = new MBC3(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC3(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x10: {
-            mbc = new MBC3(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC3(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x11: {
-            mbc = new MBC3(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC3(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x12: {
-            mbc = new MBC3(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC3(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x13: {
-            mbc = new MBC3(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC3(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x19: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x1A: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x1B: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x1C: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x1D: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } case 0x1E: {
-            mbc = new MBC5(memory, ram, banks_rom, banks_ram);
+            mbc = new MBC5(memory, ram, banks_ram, banks_rom);
             break;
         } default: {
             std::cerr << "Error: Unsupported MBC type: " << std::hex << (int)memory[0x147] << std::endl;
@@ -118,6 +118,9 @@ uint8_t Cartridge::MBC_read(uint16_t address) {
 void Cartridge::MBC_write(uint16_t address, uint8_t value) {
     mbc->write_byte(address, value);
 }
+int Cartridge::rom_bank(uint16_t address) {
+    return mbc->rom_bank(address);
+}
 
 void Cartridge::info() {
     std::string rom_title = std::string(memory + 0x134, memory + 0x143);
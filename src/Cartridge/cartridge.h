@@ -11,7 +11,7 @@ class Cartridge {
     public:
         std::string location;
 
-        MBC *mbc;
+        MBC *mbc = nullptr;
         uint8_t *memory;
         uint8_t *ram;
 
@@ -24,5 +24,6 @@ class Cartridge {
 
         uint8_t MBC_read(uint16_t address);
         void MBC_write(uint16_t address, uint8_t value);
+        int rom_bank(uint16_t address);
         void info();
 };
\ No newline at end of file
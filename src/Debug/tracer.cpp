@@ -0,0 +1,68 @@
+#include "tracer.h"
+#include "CPU/CPU.h"
+
+#include <iomanip>
+
+Tracer::Tracer(std::ostream &out) : out(out) {}
+
+// exec pc=0150 op=3E text="LD A, $12"
+void Tracer::instruction(CPU &cpu) {
+    // Decoding for the log shouldn't show up in it as reads
+#ifdef DEBUG_TRACE
+    Tracer *tracer = cpu.mmu->tracer;
+    cpu.mmu->tracer = nullptr;
+#endif
+    MicroOp op = cpu.decode(cpu.PC);
+#ifdef DEBUG_TRACE
+    cpu.mmu->tracer = tracer;
+#endif
+
+    out << "exec";
+    field("pc", op.address, 4);
+    field("op", op.opcode, 2);
+    out << " text=\"" << disassemble(op.address, op.opcode, op.operand) << "\"" << std::endl;
+}
+
+// read addr=FF44 value=90
+void Tracer::read(uint16_t address, uint8_t value) {
+    out << "read";
+    field("addr", address, 4);
+    field("value", value, 2);
+    out << std::endl;
+}
+
+void Tracer::write(uint16_t address, uint8_t value) {
+    out << "write";
+    field("addr", address, 4);
+    field("value", value, 2);
+    out << std::endl;
+}
+
+// Registers and timers after a step
+void Tracer::state(CPU &cpu) {
+    out << "state";
+    field("a", cpu.A, 2);
+    field("f", cpu.getFlags(), 2);
+    field("b", cpu.B, 2);
+    field("c", cpu.C, 2);
+    field("d", cpu.D, 2);
+    field("e", cpu.E, 2);
+    field("h", cpu.H, 2);
+    field("l", cpu.L, 2);
+    field("sp", cpu.SP, 4);
+    field("pc", cpu.PC, 4);
+    field("div", cpu.scheduler->timer_register(0xFF04), 2);
+    field("tima", cpu.scheduler->timer_register(0xFF05), 2);
+    field("tma", cpu.scheduler->timer_register(0xFF06), 2);
+    field("tac", cpu.scheduler->timer_register(0xFF07), 2);
+    out << std::endl;
+}
+
+// " key=value" with value as fixed-width uppercase hex, leaving the stream as it was
+void Tracer::field(const char *key, int value, int width) {
+    std::ios_base::fmtflags flags = out.flags();
+    char fill = out.fill('0');
+    out << " " << key << "=" << std::hex << std::uppercase << std::setw(width) << value;
+    out.flags(flags);
+    out.fill(fill);
+}
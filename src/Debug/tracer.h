@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+class CPU;
+
+// Debug log for the emulator core. Every event is one line starting with its kind
+// followed by fixed key=value fields, so traces can be grepped, diffed between runs
+// or loaded by a script. Only exists in the debug core (cmake -DENABLE_TRACE=ON,
+// which defines DEBUG_TRACE); the release core carries no trace hooks at all.
+class Tracer {
+    public:
+        Tracer(std::ostream &out = std::cout);
+
+        void instruction(CPU &cpu);
+        void read(uint16_t address, uint8_t value);
+        void write(uint16_t address, uint8_t value);
+        void state(CPU &cpu);
+
+    private:
+        std::ostream &out;
+
+        void field(const char *key, int value, int width);
+};
@@ -0,0 +1,72 @@
+#include "watchpoints.h"
+#include "CPU/CPU.h"
+
+#include <iomanip>
+#include <iostream>
+
+Watchpoints::Watchpoints(CPU *cpu) {
+    this->cpu = cpu;
+}
+
+void Watchpoints::add(uint16_t address, uint8_t kinds) {
+    addresses[address] |= kinds;
+    update(address >> 8, kinds);
+}
+
+void Watchpoints::remove(uint16_t address, uint8_t kinds) {
+    addresses[address] &= ~kinds;
+    update(address >> 8, kinds);
+}
+
+// Recomputes the page summary and moves the page on or off the slow paths
+void Watchpoints::update(int page, uint8_t changed) {
+    pages[page] = 0;
+    for (int i = 0; i < 0x100; i++) {
+        pages[page] |= addresses[page << 8 | i];
+    }
+    if (changed & (WATCH_READ | WATCH_WRITE)) {
+        cpu->mmu->map_page(page);
+    }
+    if (changed & WATCH_EXECUTE) {
+        cpu->block_cache.clear(); // Blocks may run into the page from the one before
+    }
+}
+
+void Watchpoints::hit(uint16_t address, uint8_t value, uint8_t kind) {
+    uint16_t pc = (kind == WATCH_EXECUTE) ? address : cpu->PC;
+    hits[total % HISTORY] = {cpu->scheduler->cycles, pc, address, value, kind};
+    total++;
+    if (break_on_hit) {
+        stopped = true;
+        cpu->block_exit = true;
+    }
+}
+
+// The buffered hits, oldest first
+std::vector<WatchHit> Watchpoints::history() {
+    std::vector<WatchHit> result;
+    uint64_t first = (total > HISTORY) ? total - HISTORY : 0;
+    for (uint64_t i = first; i < total; i++) {
+        result.push_back(hits[i % HISTORY]);
+    }
+    return result;
+}
+
+void Watchpoints::report() {
+    if (total == 0) {
+        return;
+    }
+    std::vector<WatchHit> buffered = history();
+    std::cout << std::dec << "Watchpoint hits: " << total << ", last " << buffered.size() << ":" << std::endl;
+    for (const WatchHit &hit : buffered) {
+        print(hit);
+    }
+}
+
+// <cycle> <kind> addr=C000 value=12 pc=0153
+void Watchpoints::print(const WatchHit &hit) {
+    const char *kind = (hit.kind == WATCH_READ) ? "read " : (hit.kind == WATCH_WRITE) ? "write" : "exec ";
+    std::cout << std::dec << std::setw(12) << hit.cycle << " " << kind << std::hex << std::uppercase << std::setfill('0')
+              << " addr=" << std::setw(4) << hit.address << " value=" << std::setw(2) << (int)hit.value
+              << " pc=" << std::setw(4) << hit.pc << std::dec << std::nouppercase << std::setfill(' ') << std::endl;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CPU;
+
+enum WatchKind : uint8_t {
+    WATCH_READ = 1 << 0,
+    WATCH_WRITE = 1 << 1,
+    WATCH_EXECUTE = 1 << 2,
+};
+
+struct WatchHit {
+    uint64_t cycle;   // Scheduler cycle count at the start of the step
+    uint16_t pc;      // Instruction address for execute, the PC after the access otherwise
+    uint16_t address;
+    uint8_t value;    // Byte read or written, the opcode for execute
+    uint8_t kind;
+};
+
+// Read, write and execute watchpoints. Pages holding a read or write watchpoint lose
+// their page table entry, so only their accesses reach the MMU handlers where hits
+// are checked; execute watchpoints keep their pages out of the block cache. Every
+// other page runs exactly as without watchpoints. Hits go into a ring buffer of the
+// last HISTORY hits; with break_on_hit set they also end the running block and set
+// stopped for the front end to pause on.
+class Watchpoints {
+    public:
+        static constexpr size_t HISTORY = 1024;
+
+        bool break_on_hit = false;
+        bool stopped = false;
+
+        Watchpoints(CPU *cpu);
+        void add(uint16_t address, uint8_t kinds);
+        void remove(uint16_t address, uint8_t kinds);
+        bool page_watched(int page, uint8_t kinds) { return (pages[page] & kinds) != 0; }
+        bool watched(uint16_t address, uint8_t kinds) { return (addresses[address] & kinds) != 0; }
+        void check(uint16_t address, uint8_t value, uint8_t kind) {
+            if (addresses[address] & kind) {
+                hit(address, value, kind);
+            }
+        }
+        const WatchHit &last() { return hits[(total - 1) % HISTORY]; }
+        std::vector<WatchHit> history();
+        void report();
+        static void print(const WatchHit &hit);
+
+    private:
+        CPU *cpu;
+        uint8_t addresses[0x10000] = {}; // WatchKinds per address
+        uint8_t pages[256] = {};         // WatchKinds of any address in each page
+        WatchHit hits[HISTORY];
+        uint64_t total = 0;
+
+        void hit(uint16_t address, uint8_t value, uint8_t kind);
+        void update(int page, uint8_t changed);
+};
@@ -18,6 +18,9 @@ void MBC::info() {
     std::cout << "ROM Banks: " << banks_rom << std::endl;
     std::cout << "RAM: " << ram << std::endl;
 }
+uint8_t *MBC::rom_page(uint16_t address) {
+    return rom + rom_bank(address) * 0x4000 + (address & 0x3F00);
+}
 
 uint8_t MBC0::read_byte(uint16_t address) {
     if (address < 0x8000) {
@@ -27,6 +30,9 @@ uint8_t MBC0::read_byte(uint16_t address) {
         return 0;
     }
 }
+uint8_t *MBC0::rom_page(uint16_t address) {
+    return rom + (address & 0x7F00);
+}
 void MBC0::write_byte(uint16_t address, uint8_t value) {
     if (address >= 0xA000 && address < 0xC000) {
         if (ram != nullptr) {
@@ -37,14 +43,19 @@ void MBC0::write_byte(uint16_t address, uint8_t value) {
     }
 }
 
+int MBC1::rom_bank(uint16_t address) {
+    if (address < 0x4000) {
+        return is_ram_bank * (bank_ram << 5) % banks_rom;
+    }
+    int bank = ((bank_ram << 5) | bank_rom) % banks_rom;
+    if (bank == 0){ bank = 1;  }// Ensure bank is valid
+    return bank;
+}
 uint8_t MBC1::read_byte(uint16_t address) {
     if (address < 0x4000) {
-        int bank = is_ram_bank * (bank_ram << 5) % banks_ram;
-        return rom[bank * 0x4000 + address];
+        return rom[rom_bank(address) * 0x4000 + address];
     } else if (address >= 0x4000 && address < 0x8000) {
-        int bank = ((bank_ram << 5) | bank_rom) % banks_rom;
-        if (bank == 0){ bank = 1;  }// Ensure bank is valid
-        return rom[bank * 0x4000 + (address - 0x4000)];
+        return rom[rom_bank(address) * 0x4000 + (address - 0x4000)];
     } else if (address >= 0xA000 && address < 0xC000) {
         if (is_ram_extended == true) {
             int bank = is_ram_bank * bank_ram % banks_ram;
@@ -86,6 +97,9 @@ void MBC1::write_byte(uint16_t address, uint8_t value) {
     }
 }
 
+int MBC2::rom_bank(uint16_t address) {
+    return (address < 0x4000) ? 0 : bank_rom;
+}
 uint8_t MBC2::read_byte(uint16_t address) {
     if (address < 0x4000) {
         return rom[address];
@@ -124,6 +138,9 @@ void MBC2::write_byte(uint16_t address, uint8_t value) {
     }
 }
 
+int MBC3::rom_bank(uint16_t address) {
+    return (address < 0x4000) ? 0 : bank_rom;
+}
 uint8_t MBC3::read_byte(uint16_t address) {
     if (address < 0x4000) {
         return rom[address];
@@ -157,6 +174,9 @@ void MBC3::write_byte(uint16_t address, uint8_t value) {
     }
 }
 
+int MBC5::rom_bank(uint16_t address) {
+    return (address < 0x4000) ? 0 : bank_rom;
+}
 uint8_t MBC5::read_byte(uint16_t address) {
     if (address < 0x4000) {
         return rom[address];
@@ -182,7 +202,7 @@ void MBC5::write_byte(uint16_t address, uint8_t value) {
     } else if (address >= 0x3000 && address < 0x4000) {
         bank_rom = (bank_rom & 0xFF) | ((value & 0x01) << 8);
     } else if (address >= 0x4000 && address < 0x6000) {
-        bank_ram = (value & 0x0F) % banks_ram;
+        bank_ram = banks_ram ? (value & 0x0F) % banks_ram : 0;
     } else if (address >= 0xA000 && address < 0xC000) {
         if (is_ram_extended) {
             ram[bank_ram * 0x2000 + address - 0xA000] = value;
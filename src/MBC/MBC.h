@@ -9,8 +9,12 @@ class MBC {
         int banks_ram = 1;
         int banks_rom = 1;
         
+        virtual ~MBC() = default;
+        virtual MBC *clone() const = 0; // Copy of the bank state, for rewinding
         virtual uint8_t read_byte(uint16_t address) = 0;
         virtual void write_byte(uint16_t address, uint8_t value) = 0;
+        virtual int rom_bank(uint16_t /*address*/) { return 0; } // ROM bank mapped at address
+        virtual uint8_t *rom_page(uint16_t address); // ROM page mapped at address, for the MMU's page table
         void info();
 
         MBC(uint8_t *rom, uint8_t *ram);
@@ -19,8 +23,10 @@ class MBC {
 class MBC0 : public MBC { 
     public:
         using MBC::MBC;
+        MBC *clone() const { return new MBC0(*this); }
         uint8_t read_byte(uint16_t address);
         void write_byte(uint16_t address, uint8_t value);
+        uint8_t *rom_page(uint16_t address);
 };
 class MBC1 : public MBC {
     public:
@@ -29,8 +35,10 @@ class MBC1 : public MBC {
         bool is_ram_bank = false; // Starts in ROM bank
         bool is_ram_extended = false;
         using MBC::MBC;
+        MBC *clone() const { return new MBC1(*this); }
         uint8_t read_byte(uint16_t address);
         void write_byte(uint16_t address, uint8_t value);
+        int rom_bank(uint16_t address);
 };
 class MBC2 : public MBC {
     public:
@@ -39,8 +47,10 @@ class MBC2 : public MBC {
         bool is_ram_bank = false;
         bool is_ram_extended = false;
         using MBC::MBC;
+        MBC *clone() const { return new MBC2(*this); }
         uint8_t read_byte(uint16_t address);
         void write_byte(uint16_t address, uint8_t value);
+        int rom_bank(uint16_t address);
 };
 class MBC3 : public MBC {
     public:
@@ -49,8 +59,10 @@ class MBC3 : public MBC {
         bool is_ram_bank = false;
         bool is_ram_extended = false;
         using MBC::MBC;
+        MBC *clone() const { return new MBC3(*this); }
         uint8_t read_byte(uint16_t address);
         void write_byte(uint16_t address, uint8_t value);
+        int rom_bank(uint16_t address);
 };
 class MBC5 : public MBC {
     public:
@@ -59,6 +71,8 @@ class MBC5 : public MBC {
         bool is_ram_bank = false;
         bool is_ram_extended = false;
         using MBC::MBC;
+        MBC *clone() const { return new MBC5(*this); }
         uint8_t read_byte(uint16_t address);
         void write_byte(uint16_t address, uint8_t value);
+        int rom_bank(uint16_t address);
 };
\ No newline at end of file
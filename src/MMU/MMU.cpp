@@ -1,51 +1,146 @@
 #include "MMU.h"
+#include "CPU/block_cache.h"
+#include "Debug/watchpoints.h"
+#include "Scheduler/scheduler.h"
+#include "tile_decoder.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 MMU::MMU(Cartridge* cartridge) {
     this->cartridge = cartridge;
+    for (int i = 0; i < 0x80; i++) {
+        io[i] = {read_io_memory, write_io_memory, this};
+    }
+    register_io(0xFF0F, this, read_io_memory, write_interrupt_flag);
+    register_io(0xFF50, this, read_io_memory, write_boot_rom_disable);
+    map_pages(0x00, 0xFF);
+}
+
+// Routes accesses to the I/O register at address (0xFF00-0xFF7F) to read and write
+void MMU::register_io(uint16_t address, void *owner, IORead read, IOWrite write) {
+    io[address - 0xFF00] = {read, write, owner};
+}
+
+uint8_t MMU::read_io_memory(void *mmu, uint16_t address) {
+    return ((MMU*)mmu)->memory[address];
+}
+
+void MMU::write_io_memory(void *mmu, uint16_t address, uint8_t value) {
+    ((MMU*)mmu)->memory[address] = value;
+}
+
+void MMU::write_interrupt_flag(void *mmu, uint16_t address, uint8_t value) {
+    MMU *self = (MMU*)mmu;
+    self->memory[address] = value;
+    self->update_pending_interrupts();
+}
+
+void MMU::write_boot_rom_disable(void *mmu, uint16_t /*address*/, uint8_t /*value*/) {
+    MMU *self = (MMU*)mmu;
+    self->rom_disabled = true;
+    self->map_page(0x00);
+    if (self->block_cache != nullptr) {
+        self->block_cache->bank_switched();
+    }
+}
+
+#ifdef DEBUG_TRACE
+void MMU::set_tracer(Tracer *tracer) {
+    this->tracer = tracer;
+}
+#endif
+
+// What reads from page return when nothing intercepts them: ROM, VRAM or work
+// RAM. nullptr for cartridge RAM, OAM and I/O, which need read_handler.
+uint8_t *MMU::page_memory(int page) {
+    uint16_t address = page << 8;
+    if (address < 0x8000) {
+        if (address < 0x100 && !rom_disabled) {
+            return memory; // Boot ROM overlay
+        } else if (cartridge->mbc != nullptr) {
+            return cartridge->mbc->rom_page(address);
+        }
+    } else if (address < 0xA000 || (address >= 0xC000 && address < 0xFE00)) {
+        return &memory[address];
+    }
+    return nullptr;
+}
+
+// Points the page table entries for page at whatever currently backs it. Called
+// again whenever that changes: bank switches, the boot ROM being unmapped, the
+// block cache starting or stopping to hold code in a page, watchpoints, and OAM
+// DMA, which sends every access through the handlers for the bus conflict checks.
+void MMU::map_page(int page) {
+    uint16_t address = page << 8;
+    read_pages[page] = nullptr;
+    write_pages[page] = nullptr;
+    if (dma_active()) {
+        return;
+    }
+    bool watched_reads = watchpoints != nullptr && watchpoints->page_watched(page, WATCH_READ);
+    bool watched_writes = watchpoints != nullptr && watchpoints->page_watched(page, WATCH_WRITE);
+    uint8_t *backing = page_memory(page);
+    if (!watched_reads) {
+        read_pages[page] = backing;
+    }
+    if (backing != nullptr && address >= 0x8000 && !watched_writes) {
+        bool tile_data = address < 0x9800;
+        bool code = block_cache != nullptr && block_cache->holds_code(address);
+        if (!tile_data && !code) {
+            write_pages[page] = &memory[address];
+        }
+    }
 }
 
-void MMU::set_debug() {
-    debug_mode = true;
+void MMU::map_pages(int first, int last) {
+    for (int page = first; page <= last; page++) {
+        map_page(page);
+    }
 }
 
 bool MMU::is_interrupt_enabled(uint8_t interruptFlag) {
-    return (this->read_byte(0xFFFF) & interruptFlag);
+    return (this->peek(0xFFFF) & interruptFlag);
 }
 bool MMU::is_interrupt_flag_enabled(uint8_t interruptFlag) {
-    return (this->read_byte(0xFF0F) & interruptFlag);
+    return (this->peek(0xFF0F) & interruptFlag);
 }
 void MMU::set_interrupt_flag(uint8_t interruptFlag) {
-    uint8_t interrupt_flag = this->read_byte(0xFF0F);
+    uint8_t interrupt_flag = this->peek(0xFF0F);
     interrupt_flag |= interruptFlag;
-    write_byte(0xFF0F, interrupt_flag);
+    poke(0xFF0F, interrupt_flag);
     return;
 }
 void MMU::unset_interrupt_flag(uint8_t interruptFlag) {
-    uint8_t interrupt_flag = this->read_byte(0xFF0F);
+    uint8_t interrupt_flag = this->peek(0xFF0F);
     interrupt_flag &= ~interruptFlag;
-    write_byte(0xFF0F, interrupt_flag);
+    poke(0xFF0F, interrupt_flag);
     return;
 }
+// Called for writes to IE or IF, and after anything that fills memory directly
+void MMU::update_pending_interrupts() {
+    pending_interrupts = memory[0xFFFF] & memory[0xFF0F] & 0x1F;
+}
 
-uint8_t MMU::read_byte(uint16_t address) {
-    if (debug_mode) {
-        std::cout << "Reading from address: " << std::hex << address << std::endl;
+uint8_t MMU::read_handler(uint16_t address) {
+    uint8_t value = read_bus(address);
+    if (watchpoints != nullptr) {
+        watchpoints->check(address, value, WATCH_READ);
     }
+    return value;
+}
 
-    switch (address) {
-        case 0xFF04: {
-            return DIV;
-        } case 0xFF05: { 
-            return TIMA;
-        } case 0xFF06: {
-            return TMA;
-        } case 0xFF07: {
-            return TAC;
-        } case 0xFF0F: {
-            return memory[0xFF0F];
+uint8_t MMU::read_bus(uint16_t address) {
+    if (address >= 0xFF00 && address < 0xFF80) {
+        IORegister &reg = io[address - 0xFF00];
+        return reg.read(reg.owner, address);
+    }
+    if (dma_active() && dma_conflict(address)) {
+        if (address >= 0xFE00) {
+            return 0xFF;
         }
+        return dma_source[std::min<uint64_t>((scheduler->cycles - dma_start) / 4, 159)]; // The byte the DMA is moving
     }
     if (address < 0x100 && !rom_disabled) {
         return memory[address];
@@ -57,64 +152,47 @@ uint8_t MMU::read_byte(uint16_t address) {
     return memory[address];
 }
 
-void MMU::write_byte(uint16_t address, uint8_t value) {
-    if (debug_mode) {
-        std::cout << "Writing to address: " << std::hex << address << " value: " << (int)value << std::endl;
+void MMU::write_handler(uint16_t address, uint8_t value) {
+    if (watchpoints != nullptr) {
+        watchpoints->check(address, value, WATCH_WRITE);
     }
+    write_bus(address, value);
+}
 
-    if (address == 0xFF40) {
-        memory[address] = value;
-        if (!(value & (1 << 7))) {
-            memory[0xFF44] = 0x00;
-            memory[0xFF41] &= 0x7C;
-        }
+void MMU::write_bus(uint16_t address, uint8_t value) {
+    if (address >= 0xFF00 && address < 0xFF80) {
+        IORegister &reg = io[address - 0xFF00];
+        reg.write(reg.owner, address, value);
         return;
     }
     if (address >= 0xFEA0 && address <= 0xFEFF) {
         std::cout << "Writing in unused area" << std::endl;
         return;
     }
-    if (address == 0xFF46) {
-        uint16_t source = value << 8;
-        for (int i = 0; i < 160; i++) {
-            write_byte(0xFE00 + i, read_byte((value << 8) + i));
-        }
-        return;
-    }
-    if (address == 0xFF50) {
-        rom_disabled = true;
+    if (dma_active() && dma_conflict(address)) {
         return;
     }
-    else if (address == 0xFF04) {
-        DIV = 0;
-    }
-    else if (address == 0xFF05) {
-        TIMA = value;
-    }
-    else if (address == 0xFF06) {
-        TMA = value;
-    }
-    else if (address == 0xFF07) {
-        TAC = value;
-    }
-    
-    else if (address == 0xff47)
-        updatePalette(palette_BGP, value);
-    else if (address == 0xff48)
-        updatePalette(palette_OBP0, value);
-    else if (address == 0xff49)
-        updatePalette(palette_OBP1, value);
 
     if (address < 0x8000) {
         cartridge->MBC_write(address, value);
+        map_pages(0x00, 0x7F);
+        if (block_cache != nullptr) {
+            block_cache->bank_switched();
+        }
     } else if (address >= 0xA000 && address <= 0xBFFF) {
         cartridge->MBC_write(address, value);
     } else {
         memory[address] = value;
+        if (block_cache != nullptr && block_cache->holds_code(address)) {
+            block_cache->invalidate(address);
+        }
+        if (address == 0xFFFF) {
+            update_pending_interrupts();
+        }
     }
     
     if (address >= 0x8000 && address <= 0x97FF) {
-        updateTile(address, value);
+        markTile(address);
     }
 
     if (address >= 0xFE00 && address <= 0xFE9F) {
@@ -122,18 +200,141 @@ void MMU::write_byte(uint16_t address, uint8_t value) {
     }
 }
 
-void MMU::updateTile(uint16_t addres, uint8_t value) {
-    uint16_t address = addres & 0xFFFE;
+// Words that straddle a page or touch an unmapped one, as two byte accesses
+uint16_t MMU::read_word_handler(uint16_t address) {
+    uint8_t low = read_byte(address);
+    return low | (read_byte(address + 1) << 8);
+}
+
+void MMU::write_word_handler(uint16_t address, uint16_t value) {
+    write_byte(address, value & 0xFF);
+    write_byte(address + 1, value >> 8);
+}
+
+void MMU::push_word_handler(uint16_t address, uint16_t value) {
+    write_byte(address + 1, value >> 8);
+    write_byte(address, value & 0xFF);
+}
+
+// How many of the count bytes from address can be written without side effects
+// other than marking tiles: VRAM or work RAM (with its echo), not holding cached
+// code. Returns 0 while tracing, where every access is meant to be logged.
+int MMU::plain_span(uint16_t address, int count) {
+    int end;
+    if (address >= 0x8000 && address < 0xA000) {
+        end = 0xA000;
+    } else if (address >= 0xC000 && address < 0xFE00) {
+        end = 0xFE00;
+    } else {
+        return 0;
+    }
+    count = std::min(count, end - address);
+    if (dma_active()) {
+        return 0;
+    }
+#ifdef DEBUG_TRACE
+    if (tracer != nullptr) {
+        return 0;
+    }
+#endif
+    if (count <= 0) {
+        return 0;
+    }
+    for (int page = address >> 8; page <= (address + count - 1) >> 8; page++) {
+        if (block_cache != nullptr && block_cache->holds_code(page << 8)) {
+            return 0;
+        }
+        if (watchpoints != nullptr && watchpoints->page_watched(page, WATCH_WRITE)) {
+            return 0;
+        }
+    }
+    return count;
+}
+
+// Bulk equivalents of count write_byte calls. The destination must pass plain_span,
+// the source must lie below 0xFE00. Bytes go one at a time in ascending order, so
+// overlapping ranges behave exactly like the loop being replaced.
+void MMU::copy(uint16_t destination, uint16_t source, int count) {
+    for (int i = 0; i < count; i++) {
+        uint16_t from = source + i;
+        uint8_t *page = read_pages[from >> 8];
+        memory[destination + i] = (page != nullptr) ? page[from & 0xFF] : read_byte(from);
+    }
+    markTiles(destination, count);
+}
+
+void MMU::fill(uint16_t destination, uint8_t value, int count) {
+    std::memset(&memory[destination], value, count);
+    markTiles(destination, count);
+}
 
-    uint16_t tile = (address >> 4) & 511;
-    uint16_t y = (address >> 1) & 7;
+// Starts an OAM DMA from source << 8. The CPU keeps running, but for the next 160
+// machine cycles it can't reach OAM or the bus the DMA reads from (VRAM, or the
+// external bus for ROM, cartridge RAM and work RAM); only HRAM and I/O are safe.
+// OAM itself is filled in one go when the transfer ends.
+void MMU::start_dma(uint8_t source) {
+    dma_source = page_memory(source);
+    if (dma_source == nullptr) {
+        for (int i = 0; i < 160; i++) {
+            dma_staging[i] = read_bus((source << 8) + i);
+        }
+        dma_source = dma_staging;
+    }
+    dma_from_vram = source >= 0x80 && source < 0xA0;
+    dma_running = true;
+    dma_start = scheduler->cycles;
+    scheduler->schedule(EVENT_DMA, dma_start + DMA_CYCLES);
+    map_pages(0x00, 0xFF);
+    if (block_cache != nullptr) {
+        block_cache->dma_started();
+    }
+}
+
+void MMU::finish_dma(void *mmu, uint64_t deadline) {
+    MMU *self = (MMU*)mmu;
+    (void)deadline;
+    self->dma_running = false;
+    std::memcpy(&self->memory[0xFE00], self->dma_source, 160);
+    self->updateSprites();
+    self->map_pages(0x00, 0xFF);
+}
 
-    uint8_t index;
-    for (uint8_t x = 0; x < 8; x++) {
-        index = 1 << (7 - x);
-        tiles[tile].pixels[y][x] = ((memory[address] & index) ? 1 : 0) + ((memory[address + 1] & index) ? 2 : 0);
+// Whether the CPU loses an access to address to the running DMA
+bool MMU::dma_conflict(uint16_t address) {
+    if (address >= 0xFE00) {
+        return address < 0xFEA0; // OAM
     }
+    bool vram = address >= 0x8000 && address < 0xA000;
+    return dma_from_vram == vram;
 }
+
+// Marks the tiles a bulk write into VRAM touched
+void MMU::markTiles(uint16_t address, int count) {
+    int end = std::min(address + count, 0x9800);
+    for (int row = address & 0xFFF0; row < end; row += 16) {
+        markTile(row);
+    }
+}
+
+// Tile data writes only mark their tile; the PPU decodes everything marked before it
+// draws a scanline, so a tile being loaded is decoded once, not per byte. Each run of
+// consecutive dirty tiles goes to the decoder in one call.
+void MMU::decodeDirtyTiles() {
+    for (int word = 0; word < 6; word++) {
+        uint64_t bits = dirty_tiles[word];
+        while (bits != 0) {
+            int first = __builtin_ctzll(bits);
+            uint64_t run = bits >> first;
+            int count = (run == ~0ULL) ? 64 : __builtin_ctzll(~run);
+            int tile = word * 64 + first;
+            TileDecoder::decodeTiles(&memory[0x8000 + tile * 16], &tiles[tile], count);
+            bits = (count + first == 64) ? 0 : bits & (~0ULL << (first + count));
+        }
+        dirty_tiles[word] = 0;
+    }
+    tiles_dirty = false;
+}
+
 void MMU::updateSprite(uint16_t addres, uint8_t value) {
     uint16_t address = addres - 0xFE00;
     Sprite *sprite = &sprites[address >> 2];
@@ -156,13 +357,15 @@ void MMU::updateSprite(uint16_t addres, uint8_t value) {
     }
 }
 
+void MMU::updateSprites() {
+    for (uint16_t address = 0xFE00; address < 0xFEA0; address++) {
+        updateSprite(address, memory[address]);
+    }
+}
+
 void MMU::updatePalette(Colour *palette, uint8_t value) {
     palette[0] = palette_colours[value & 0x3];
     palette[1] = palette_colours[(value >> 2) & 0x3];
     palette[2] = palette_colours[(value >> 4) & 0x3];
     palette[3] = palette_colours[(value >> 6) & 0x3];
 }
-
-void MMU::info() {
-    std::cout << "DIV: " << (int)DIV << " TIMA: " << (int)TIMA << " TMA: " << (int)TMA << " TAC: " << (int)TAC << std::endl;
-}
\ No newline at end of file
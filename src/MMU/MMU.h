@@ -1,34 +1,48 @@
 #pragma once
 #include "Cartridge/cartridge.h"
 #include "structs.h"
+#ifdef DEBUG_TRACE
+#include "Debug/tracer.h"
+#endif
+
+class BlockCache;
+class Scheduler;
+class Watchpoints;
+
+// Handlers for one I/O register. owner is whatever registered them.
+typedef uint8_t (*IORead)(void *owner, uint16_t address);
+typedef void (*IOWrite)(void *owner, uint16_t address, uint8_t value);
 
 class MMU {
     public:
         Cartridge *cartridge;
-        uint8_t memory[0xFFFF];
-        uint8_t interrupt_enable = memory[0xFFFF];
-        uint8_t interrupt_flags = memory[0xFF0F];
-        int timer_cycles = 0;
-
-        uint16_t DIV = 0;
-        uint16_t TIMA = 0;
-        uint16_t TMA = 0;
-        uint16_t TAC = 0;
+        BlockCache *block_cache = nullptr;
+        Watchpoints *watchpoints = nullptr;
+        Scheduler *scheduler = nullptr; // Set by the scheduler, which times DMA
+        uint8_t memory[0x10000] = {};
+        // Base of each 256-byte page, or nullptr where accesses need read_handler or
+        // write_handler: cartridge RAM, OAM and I/O, plus writes to ROM (MBC control),
+        // tile data and pages holding cached code
+        uint8_t *read_pages[256] = {};
+        uint8_t *write_pages[256] = {};
+        uint8_t pending_interrupts = 0; // IE & IF, kept current on every write to either
 
         static constexpr uint8_t VBLANK = (1 << 0);
         static constexpr uint8_t LCD = (1 << 1);
         static constexpr uint8_t TIMER = (1 << 2);
         static constexpr uint8_t SERIAL = (1 << 3);
+        static constexpr uint8_t JOYPAD = (1 << 4);
 
         bool rom_disabled = false;
-        bool trigger_halted = false;
-        bool debug_mode = false;
+#ifdef DEBUG_TRACE
+        Tracer *tracer = nullptr; // Logs every access while set
+#endif
 
         Sprite sprites[40] = {Sprite()};
-        Tile tiles[384];
+        Tile tiles[384]; // Decoded lazily, call decodeTiles before reading
 
         Colour *colour;
-        const Colour palette_colours[4] = {
+        static constexpr Colour palette_colours[4] = {
             {255, 255, 255, 255}, // White
             {192, 192, 192, 255}, // Light Gray
             {96, 96, 96, 255},    // Dark Gray
@@ -57,15 +71,172 @@ class MMU {
         
 
         MMU(Cartridge* cartridge);
-        uint8_t read_byte(uint16_t address);
-        void set_debug();
-        void write_byte(uint16_t address, uint8_t value);
-        void updateTile(uint16_t address, uint8_t value);
+        uint8_t read_byte(uint16_t address) {
+            uint8_t *page = read_pages[address >> 8];
+            uint8_t value = page != nullptr ? page[address & 0xFF] : read_handler(address);
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                tracer->read(address, value);
+            }
+#endif
+            return value;
+        }
+        void write_byte(uint16_t address, uint8_t value) {
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                tracer->write(address, value);
+            }
+#endif
+            uint8_t *page = write_pages[address >> 8];
+            if (page != nullptr) {
+                page[address & 0xFF] = value;
+            } else {
+                write_handler(address, value);
+            }
+        }
+        // Accesses that aren't CPU loads or stores: instruction fetch, the PPU and the
+        // interrupt flags. Same as read_byte and write_byte, but never reported to
+        // watchpoints
+        uint8_t peek(uint16_t address) {
+            uint8_t *page = read_pages[address >> 8];
+            uint8_t value = page != nullptr ? page[address & 0xFF] : read_bus(address);
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                tracer->read(address, value);
+            }
+#endif
+            return value;
+        }
+        void poke(uint16_t address, uint8_t value) {
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                tracer->write(address, value);
+            }
+#endif
+            uint8_t *page = write_pages[address >> 8];
+            if (page != nullptr) {
+                page[address & 0xFF] = value;
+            } else {
+                write_bus(address, value);
+            }
+        }
+        // Little-endian 16-bit accesses. Both bytes on one mapped page take a single
+        // access; otherwise, and while tracing, they are two byte accesses with the
+        // usual handler side effects: low byte first, except for push_word, which
+        // writes the high byte first like PUSH, CALL, RST and interrupt dispatch
+        uint16_t read_word(uint16_t address) {
+            uint8_t *page = read_pages[address >> 8];
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                page = nullptr;
+            }
+#endif
+            if (page != nullptr && (address & 0xFF) != 0xFF) {
+                const uint8_t *bytes = page + (address & 0xFF);
+                return bytes[0] | (bytes[1] << 8);
+            }
+            return read_word_handler(address);
+        }
+        void write_word(uint16_t address, uint16_t value) {
+            uint8_t *page = write_pages[address >> 8];
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                page = nullptr;
+            }
+#endif
+            if (page != nullptr && (address & 0xFF) != 0xFF) {
+                uint8_t *bytes = page + (address & 0xFF);
+                bytes[0] = value & 0xFF;
+                bytes[1] = value >> 8;
+                return;
+            }
+            write_word_handler(address, value);
+        }
+        // Stores a word pushed onto the stack, address being the new SP
+        void push_word(uint16_t address, uint16_t value) {
+            uint8_t *page = write_pages[address >> 8];
+#ifdef DEBUG_TRACE
+            if (tracer != nullptr) {
+                page = nullptr;
+            }
+#endif
+            if (page != nullptr && (address & 0xFF) != 0xFF) {
+                uint8_t *bytes = page + (address & 0xFF);
+                bytes[0] = value & 0xFF;
+                bytes[1] = value >> 8;
+                return;
+            }
+            push_word_handler(address, value);
+        }
+        // 16-bit immediate of the instruction whose opcode is at address
+        uint16_t fetch_imm16(uint16_t address) { return peek(address + 1) | (peek(address + 2) << 8); }
+        uint8_t read_handler(uint16_t address);
+        void write_handler(uint16_t address, uint8_t value);
+        uint16_t read_word_handler(uint16_t address);
+        void write_word_handler(uint16_t address, uint16_t value);
+        void push_word_handler(uint16_t address, uint16_t value);
+        void register_io(uint16_t address, void *owner, IORead read, IOWrite write);
+        void map_page(int page);
+        void map_pages(int first, int last);
+#ifdef DEBUG_TRACE
+        void set_tracer(Tracer *tracer);
+#endif
+        int plain_span(uint16_t address, int count);
+        void copy(uint16_t destination, uint16_t source, int count);
+        void fill(uint16_t destination, uint8_t value, int count);
+        void start_dma(uint8_t source);
+        bool dma_active() { return dma_running; }
+        static void finish_dma(void *mmu, uint64_t deadline);
+        void markTile(uint16_t address) {
+            int tile = (address >> 4) & 511;
+            dirty_tiles[tile >> 6] |= 1ULL << (tile & 63);
+            tiles_dirty = true;
+        }
+        void markTiles(uint16_t address, int count);
+        void decodeTiles() {
+            if (tiles_dirty) {
+                decodeDirtyTiles();
+            }
+        }
         void updatePalette(Colour *palette, uint8_t value);
         void updateSprite(uint16_t address, uint8_t value);
+        void updateSprites();
         bool is_interrupt_enabled(uint8_t interruptFlag);
         bool is_interrupt_flag_enabled(uint8_t interruptFlag);
         void set_interrupt_flag(uint8_t interruptFlag);
         void unset_interrupt_flag(uint8_t interruptFlag);
-        void info();
+        void update_pending_interrupts();
+
+    private:
+        // 0xFF00-0xFF7F. Subsystems register the registers they own when they are
+        // constructed, everything else reads and writes memory[].
+        struct IORegister {
+            IORead read;
+            IOWrite write;
+            void *owner;
+        };
+        IORegister io[0x80];
+
+        // OAM DMA in flight: 160 bytes at one per machine cycle
+        static constexpr int DMA_CYCLES = 160 * 4;
+        const uint8_t *dma_source = nullptr;
+        uint8_t dma_staging[160]; // Source copy when it isn't plain memory
+        bool dma_from_vram = false;
+        bool dma_running = false;
+        uint64_t dma_start = 0; // Scheduler cycle count when it started
+
+        // Tiles whose VRAM changed since they were last decoded, one bit each
+        uint64_t dirty_tiles[6] = {};
+        bool tiles_dirty = false;
+
+        void decodeDirtyTiles();
+        uint8_t *page_memory(int page);
+        uint8_t read_bus(uint16_t address);
+        void write_bus(uint16_t address, uint8_t value);
+        bool dma_conflict(uint16_t address);
+
+        static uint8_t read_io_memory(void *mmu, uint16_t address);
+        static void write_io_memory(void *mmu, uint16_t address, uint8_t value);
+        static void write_interrupt_flag(void *mmu, uint16_t address, uint8_t value);
+        static void write_boot_rom_disable(void *mmu, uint16_t address, uint8_t value);
 };
\ No newline at end of file
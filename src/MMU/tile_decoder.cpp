@@ -0,0 +1,180 @@
+#include "tile_decoder.h"
+
+#include <cstring>
+
+#if TILE_DECODER_X86
+#include <immintrin.h>
+#endif
+
+TileDecoder::DecodeTiles TileDecoder::active = nullptr;
+TileDecoder::Backend TileDecoder::active_backend = TileDecoder::LOOKUP;
+
+namespace {
+    // Each bitplane byte spread to one byte per pixel, leftmost pixel first. Built from
+    // byte arrays so the same table works on either endianness.
+    struct SpreadTable {
+        uint64_t rows[256];
+
+        SpreadTable() {
+            for (int value = 0; value < 256; value++) {
+                uint8_t pixels[8];
+                for (int x = 0; x < 8; x++) {
+                    pixels[x] = (value >> (7 - x)) & 1;
+                }
+                std::memcpy(&rows[value], pixels, 8);
+            }
+        }
+    };
+
+    const SpreadTable spread;
+
+    uint64_t spreadRow(uint8_t low, uint8_t high) {
+        return spread.rows[low] | (spread.rows[high] << 1);
+    }
+}
+
+void TileDecoder::decodeRow(uint8_t low, uint8_t high, uint8_t *pixels) {
+    uint64_t row = spreadRow(low, high);
+    std::memcpy(pixels, &row, 8);
+}
+
+TileDecoder::Backend TileDecoder::backend() {
+    decoder();
+    return active_backend;
+}
+
+bool TileDecoder::supported(Backend backend) {
+#if TILE_DECODER_X86
+    __builtin_cpu_init();
+    switch (backend) {
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SSE2:
+            return __builtin_cpu_supports("sse2");
+        case LOOKUP:
+            return true;
+    }
+    return false;
+#else
+    return backend == LOOKUP;
+#endif
+}
+
+bool TileDecoder::select(Backend backend) {
+    if (!supported(backend)) {
+        return false;
+    }
+    switch (backend) {
+#if TILE_DECODER_X86
+        case AVX2:
+            active = decodeAVX2;
+            break;
+        case SSE2:
+            active = decodeSSE2;
+            break;
+#endif
+        default:
+            active = decodeLookup;
+            break;
+    }
+    active_backend = backend;
+    return true;
+}
+
+const char *TileDecoder::name(Backend backend) {
+    switch (backend) {
+        case AVX2:
+            return "AVX2";
+        case SSE2:
+            return "SSE2";
+        case LOOKUP:
+            return "lookup";
+    }
+    return "unknown";
+}
+
+TileDecoder::Backend TileDecoder::detect() {
+    if (supported(AVX2)) {
+        return AVX2;
+    }
+    if (supported(SSE2)) {
+        return SSE2;
+    }
+    return LOOKUP;
+}
+
+void TileDecoder::decodeLookup(const uint8_t *data, Tile *tiles, int count) {
+    for (int tile = 0; tile < count; tile++, data += 16) {
+        for (int y = 0; y < 8; y++) {
+            uint64_t row = spreadRow(data[y * 2], data[y * 2 + 1]);
+            std::memcpy(tiles[tile].pixels[y], &row, 8);
+        }
+    }
+}
+
+#if TILE_DECODER_X86
+
+// Two rows per vector. SSE2 has no byte shuffle, so the bitplanes are separated and
+// each byte repeated eight times through successive unpacks. Masking each lane with
+// its pixel's bit and clamping to 1 leaves that pixel's bit of the plane.
+__attribute__((target("sse2")))
+void TileDecoder::decodeSSE2(const uint8_t *data, Tile *tiles, int count) {
+    const __m128i bits = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                       (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (int tile = 0; tile < count; tile++, data += 16) {
+        __m128i row_data = _mm_loadu_si128((const __m128i*)data);
+        __m128i low = _mm_packus_epi16(_mm_and_si128(row_data, low_bytes), zero);  // l0 .. l7
+        __m128i high = _mm_packus_epi16(_mm_srli_epi16(row_data, 8), zero);         // h0 .. h7
+        low = _mm_unpacklo_epi8(low, low);
+        high = _mm_unpacklo_epi8(high, high);
+        __m128i lows[2] = {_mm_unpacklo_epi16(low, low), _mm_unpackhi_epi16(low, low)};
+        __m128i highs[2] = {_mm_unpacklo_epi16(high, high), _mm_unpackhi_epi16(high, high)};
+
+        uint8_t *pixels = &tiles[tile].pixels[0][0];
+        for (int half = 0; half < 2; half++) {
+            __m128i l[2] = {_mm_unpacklo_epi32(lows[half], lows[half]), _mm_unpackhi_epi32(lows[half], lows[half])};
+            __m128i h[2] = {_mm_unpacklo_epi32(highs[half], highs[half]), _mm_unpackhi_epi32(highs[half], highs[half])};
+            for (int pair = 0; pair < 2; pair++) {
+                __m128i colour_low = _mm_min_epu8(_mm_and_si128(l[pair], bits), one);
+                __m128i colour_high = _mm_min_epu8(_mm_and_si128(h[pair], bits), one);
+                _mm_storeu_si128((__m128i*)(pixels + (half * 2 + pair) * 16), _mm_add_epi8(colour_low, _mm_add_epi8(colour_high, colour_high)));
+            }
+        }
+    }
+}
+
+// Four rows per vector. The tile's 16 bytes sit in both 128-bit lanes, so an in-lane
+// byte shuffle can broadcast each row's bitplane bytes across its eight pixels.
+__attribute__((target("avx2")))
+void TileDecoder::decodeAVX2(const uint8_t *data, Tile *tiles, int count) {
+    alignas(32) static const uint8_t shuffles[4][32] = {
+        {0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6},            // Low planes, rows 0-3
+        {1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3, 3, 5, 5, 5, 5, 5, 5, 5, 5, 7, 7, 7, 7, 7, 7, 7, 7},            // High planes, rows 0-3
+        {8, 8, 8, 8, 8, 8, 8, 8, 10, 10, 10, 10, 10, 10, 10, 10, 12, 12, 12, 12, 12, 12, 12, 12, 14, 14, 14, 14, 14, 14, 14, 14}, // Low planes, rows 4-7
+        {9, 9, 9, 9, 9, 9, 9, 9, 11, 11, 11, 11, 11, 11, 11, 11, 13, 13, 13, 13, 13, 13, 13, 13, 15, 15, 15, 15, 15, 15, 15, 15}, // High planes, rows 4-7
+    };
+    const __m256i bits = _mm256_set1_epi64x(0x0102040810204080LL);
+    const __m256i one = _mm256_set1_epi8(1), two = _mm256_set1_epi8(2);
+    __m256i select[4];
+    for (int i = 0; i < 4; i++) {
+        select[i] = _mm256_load_si256((const __m256i*)shuffles[i]);
+    }
+
+    for (int tile = 0; tile < count; tile++, data += 16) {
+        __m256i row_data = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)data));
+        uint8_t *pixels = &tiles[tile].pixels[0][0];
+        for (int half = 0; half < 2; half++) {
+            __m256i low = _mm256_and_si256(_mm256_shuffle_epi8(row_data, select[half * 2]), bits);
+            __m256i high = _mm256_and_si256(_mm256_shuffle_epi8(row_data, select[half * 2 + 1]), bits);
+            __m256i colour = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(low, bits), one),
+                                             _mm256_and_si256(_mm256_cmpeq_epi8(high, bits), two));
+            _mm256_storeu_si256((__m256i*)(pixels + half * 32), colour);
+        }
+    }
+}
+
+#endif
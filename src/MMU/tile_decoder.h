@@ -0,0 +1,48 @@
+#pragma once
+
+#include "structs.h"
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TILE_DECODER_X86 1
+#else
+#define TILE_DECODER_X86 0
+#endif
+
+// Turns 2bpp tile data, two bitplane bytes per row, into one colour index (0-3) per
+// pixel. The widest backend the host supports is picked the first time it is used:
+// AVX2 decodes a whole tile in two 32-byte vectors, SSE2 two rows per vector, and the
+// lookup backend spreads each bitplane byte through a 256-entry table.
+class TileDecoder {
+    public:
+        enum Backend { LOOKUP, SSE2, AVX2 };
+
+        static void decodeRow(uint8_t low, uint8_t high, uint8_t *pixels);
+        static void decodeTile(const uint8_t *data, Tile &tile) { decodeTiles(data, &tile, 1); }
+        static void decodeTiles(const uint8_t *data, Tile *tiles, int count) { decoder()(data, tiles, count); }
+
+        static Backend backend();
+        static bool supported(Backend backend);
+        static bool select(Backend backend); // Forces a backend, false if the host lacks it
+        static const char *name(Backend backend);
+
+    private:
+        typedef void (*DecodeTiles)(const uint8_t *data, Tile *tiles, int count);
+
+        static DecodeTiles active;
+        static Backend active_backend;
+
+        static DecodeTiles decoder() {
+            if (active == nullptr) {
+                select(detect());
+            }
+            return active;
+        }
+        static Backend detect();
+        static void decodeLookup(const uint8_t *data, Tile *tiles, int count);
+#if TILE_DECODER_X86
+        static void decodeSSE2(const uint8_t *data, Tile *tiles, int count);
+        static void decodeAVX2(const uint8_t *data, Tile *tiles, int count);
+#endif
+};
@@ -25,85 +25,116 @@ PPU::PPU(CPU *cpu, MMU *mmu) {
     vblank_interrupt = (*stat >> 4) & 1;
     oam_interrupt = (*stat >> 5) & 1;
     coincidence_interrupt = (*stat >> 6) & 1;
+
+    mmu->register_io(0xFF40, this, read_register, write_lcdc);
+    mmu->register_io(0xFF46, this, read_register, write_dma);
+    mmu->register_io(0xFF47, this, read_register, write_palette);
+    mmu->register_io(0xFF48, this, read_register, write_palette);
+    mmu->register_io(0xFF49, this, read_register, write_palette);
+
+    Scheduler *scheduler = cpu->scheduler;
+    scheduler->ppu = this;
+    scheduler->register_event(EVENT_PPU, this, mode_event);
+    if (lcd_enable) {
+        scheduler->schedule(EVENT_PPU, scheduler->cycles + MODE_CYCLES[mode]);
+    }
+}
+
+uint8_t PPU::read_register(void *ppu, uint16_t address) {
+    return ((PPU*)ppu)->mmu->memory[address];
+}
+
+// Turning the LCD off resets LY and the STAT mode
+void PPU::write_lcdc(void *ppu, uint16_t address, uint8_t value) {
+    MMU *mmu = ((PPU*)ppu)->mmu;
+    mmu->memory[address] = value;
+    if (!(value & (1 << 7))) {
+        mmu->memory[0xFF44] = 0x00;
+        mmu->memory[0xFF41] &= 0x7C;
+    }
+}
+
+// OAM DMA from value << 8, run by the MMU over the next 160 machine cycles
+void PPU::write_dma(void *ppu, uint16_t address, uint8_t value) {
+    MMU *mmu = ((PPU*)ppu)->mmu;
+    mmu->memory[address] = value;
+    mmu->start_dma(value);
+}
+
+void PPU::write_palette(void *ppu, uint16_t address, uint8_t value) {
+    MMU *mmu = ((PPU*)ppu)->mmu;
+    mmu->memory[address] = value;
+    Colour *palettes[3] = {mmu->palette_BGP, mmu->palette_OBP0, mmu->palette_OBP1};
+    mmu->updatePalette(palettes[address - 0xFF47], value);
 }
 
 void PPU::render_scanline() {
+    mmu->decodeTiles();
     bool rows[160] = {0};
     render_background(rows);
     render_sprites(rows);
     render_window();
 }
 
-void PPU::step(int cycles) {
-    modeclock += cycles;
-
-    if (lcd_enable == 0) {
-        mode = 0;
-        if (modeclock >= 70224)
-            modeclock -= 70224;
-        return;
-    }
+// Runs the mode change due at deadline and schedules the next one, counted from
+// deadline so a late run doesn't shift the ones after it
+void PPU::mode_event(void *ppu, uint64_t deadline) {
+    PPU *self = (PPU*)ppu;
+    self->change_mode();
+    self->cpu->scheduler->schedule(EVENT_PPU, deadline + MODE_CYCLES[self->mode & 3]);
+}
 
+// Leaves the current mode, or in VBlank the current line, updating LY, LY=LYC and
+// STAT and requesting the STAT and VBlank interrupts
+void PPU::change_mode() {
     switch (mode) {
         case 0:  { // HBLANK
-            if (modeclock >= 204) {
-                modeclock -= 204;
-                mode = 2;
+            mode = 2;
 
-                *scanline += 1;
-                uint8_t lyc = mmu->read_byte(0xFF45);
-                coincidence_flag = int(lyc == *scanline);
+            *scanline += 1;
+            uint8_t lyc = mmu->peek(0xFF45);
+            coincidence_flag = int(lyc == *scanline);
 
-                if (lyc == *scanline && coincidence_interrupt)
-                    mmu->set_interrupt_flag(mmu->LCD);
+            if (lyc == *scanline && coincidence_interrupt)
+                mmu->set_interrupt_flag(mmu->LCD);
 
-                if (*scanline == 144) {
-                    mode = 1;
-                    can_render = true;
-                    mmu->set_interrupt_flag(mmu->VBLANK);
-                    if (vblank_interrupt)
-                        mmu->set_interrupt_flag(mmu->LCD);
-                } else if (oam_interrupt)
+            if (*scanline == 144) {
+                mode = 1;
+                can_render = true;
+                mmu->set_interrupt_flag(mmu->VBLANK);
+                if (vblank_interrupt)
                     mmu->set_interrupt_flag(mmu->LCD);
+            } else if (oam_interrupt)
+                mmu->set_interrupt_flag(mmu->LCD);
 
-                mmu->write_byte(0xff41, (mmu->read_byte(0xff41) & 0xFC) | (mode & 3));
-            }
+            mmu->poke(0xff41, (mmu->peek(0xff41) & 0xFC) | (mode & 3));
             break;
         } case 1:  { // VBLANK
-            if (modeclock >= 456) {
-                modeclock -= 456;
-                *scanline += 1;
-                uint8_t lyc = mmu->read_byte(0xFF45);
-                coincidence_flag = int(lyc == *scanline);
-
-                if (lyc == *scanline && coincidence_interrupt)
+            *scanline += 1;
+            uint8_t lyc = mmu->peek(0xFF45);
+            coincidence_flag = int(lyc == *scanline);
+
+            if (lyc == *scanline && coincidence_interrupt)
+                mmu->set_interrupt_flag(mmu->LCD);
+            if (*scanline == 153) {
+                *scanline = 0;
+                mode = 2;
+                mmu->poke(0xff41, (mmu->peek(0xff41) & 0xFC) | (mode & 3));
+                if (oam_interrupt)
                     mmu->set_interrupt_flag(mmu->LCD);
-                if (*scanline == 153) {
-                    *scanline = 0;
-                    mode = 2;
-                    mmu->write_byte(0xff41, (mmu->read_byte(0xff41) & 0xFC) | (mode & 3));
-                    if (oam_interrupt)
-                        mmu->set_interrupt_flag(mmu->LCD);
-                }
             }
             break;
         } case 2:  { // OAM
-            if (modeclock >= 80) {
-                modeclock -= 80;
-                mode = 3;
-                mmu->write_byte(0xff41, (mmu->read_byte(0xff41) & 0xFC) | (mode & 3));
-            }
+            mode = 3;
+            mmu->poke(0xff41, (mmu->peek(0xff41) & 0xFC) | (mode & 3));
             break;
         } case 3:  { // VRAM
-            if (modeclock >= 172) {
-                modeclock -= 172;
-                mode = 0;
-                render_scanline();
-                mmu->write_byte(0xff41, (mmu->read_byte(0xff41) & 0xFC) | (mode & 3));
+            mode = 0;
+            render_scanline();
+            mmu->poke(0xff41, (mmu->peek(0xff41) & 0xFC) | (mode & 3));
 
-                if (hblank_interrupt)
-                    mmu->set_interrupt_flag(mmu->LCD);
-            }
+            if (hblank_interrupt)
+                mmu->set_interrupt_flag(mmu->LCD);
             break;
         } default: {
             break;
@@ -133,7 +164,7 @@ void PPU::render_background(bool* rows) {
         if (tile_address >= end) {
             tile_address = start + (address % end);
         }
-        uint8_t tile = mmu->read_byte(tile_address);
+        uint8_t tile = mmu->peek(tile_address);
         
         for (x; x < 0; x++) {
             if (pixel >= 160) {
@@ -219,20 +250,20 @@ void PPU::PPU::render_window() {
     if (sprite_display_enable == 0) {
         return;
     }
-    if (mmu->read_byte(0xFF40) > *scanline) {
+    if (mmu->peek(0xFF40) > *scanline) {
         return;
     }
     uint16_t address = 0x9800;
     if (window_display_select == 1) {
         address = 0x9C00;
     }
-    address += ((*scanline - mmu->read_byte(0xFF4A)) / 8 * 32) * 32;
-    int y = (*scanline - mmu->read_byte(0xFF4A)) & 7;
+    address += ((*scanline - mmu->peek(0xFF4A)) / 8 * 32) * 32;
+    int y = (*scanline - mmu->peek(0xFF4A)) & 7;
     int x = 0;
-    int offset = *scanline * 160 + (mmu->read_byte(0xFF4B) - 7);
+    int offset = *scanline * 160 + (mmu->peek(0xFF4B) - 7);
     uint16_t tile_address = address;
     for (tile_address; tile_address < address + 20; tile_address++) {
-        int tile = mmu->read_byte(tile_address);
+        int tile = mmu->peek(tile_address);
 
         for (x; x < 8; x++) {
             if (offset > sizeof(framebuffer)) {
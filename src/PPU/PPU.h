@@ -34,14 +34,21 @@ class PPU {
         Colour framebuffer[160 * 144];
         uint8_t background[32 * 32];
     
-        int modeclock = 0;
-    
         bool can_render = false;
     
-        void step(int cycles);
         PPU(CPU *cpu, MMU *mmu);
         void render_scanline();
         void render_background(bool* rows);
         void render_sprites(bool* rows);
         void render_window();
+
+    private:
+        static constexpr int MODE_CYCLES[4] = {204, 456, 80, 172}; // Per mode, per line in VBlank
+
+        static void mode_event(void *ppu, uint64_t deadline);
+        void change_mode();
+        static uint8_t read_register(void *ppu, uint16_t address);
+        static void write_lcdc(void *ppu, uint16_t address, uint8_t value);
+        static void write_dma(void *ppu, uint16_t address, uint8_t value);
+        static void write_palette(void *ppu, uint16_t address, uint8_t value);
 };
\ No newline at end of file
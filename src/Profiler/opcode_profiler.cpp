@@ -0,0 +1,111 @@
+#include "opcode_profiler.h"
+#include "CPU/opcodes.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+OpcodeProfiler::OpcodeProfiler(const std::string &csv_path) {
+    this->csv_path = csv_path;
+}
+
+// Dumps everything when the owning CPU goes away, i.e. when the emulator exits
+OpcodeProfiler::~OpcodeProfiler() {
+    report();
+    write_csv(csv_path);
+}
+
+// JR cc, RET cc, JP cc and CALL cc
+bool OpcodeProfiler::conditional(uint8_t opcode) {
+    return OPCODES[opcode].taken_cycles != OPCODES[opcode].cycles;
+}
+
+// Prints every executed opcode sorted by the cycles it accounts for
+void OpcodeProfiler::report() {
+    struct Row {
+        int index; // 0x000 - 0x0FF opcodes, 0x100 - 0x1FF CB opcodes
+        const Entry *entry;
+    };
+    std::vector<Row> rows;
+    uint64_t total_count = 0, total_cycles = 0;
+    for (int i = 0; i < 512; i++) {
+        const Entry &entry = (i < 256) ? opcodes[i] : cb[i - 256];
+        if (entry.count != 0) {
+            rows.push_back({i, &entry});
+            total_count += entry.count;
+            total_cycles += entry.cycles;
+        }
+    }
+    if (total_count == 0) {
+        return;
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+        return a.entry->cycles > b.entry->cycles;
+    });
+
+    std::cout << std::dec << "Opcode profile: " << total_count << " instructions, " << total_cycles << " cycles" << std::endl;
+    std::cout << "opcode      count     %count      cycles    %cycles   taken" << std::endl;
+    for (const Row &row : rows) {
+        const Entry &entry = *row.entry;
+        std::cout << (row.index < 256 ? "   " : "CB ") << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                  << (row.index & 0xFF) << std::dec << std::nouppercase << std::setfill(' ')
+                  << std::setw(12) << entry.count
+                  << std::setw(10) << std::fixed << std::setprecision(2) << 100.0 * entry.count / total_count << "%"
+                  << std::setw(12) << entry.cycles
+                  << std::setw(10) << 100.0 * entry.cycles / total_cycles << "%";
+        if (row.index < 256 && conditional(row.index)) {
+            std::cout << std::setw(7) << std::setprecision(1) << 100.0 * entry.taken / entry.count << "%";
+        }
+        std::cout << std::endl;
+    }
+    report_pairs(total_count);
+}
+
+// Prints the most frequent back-to-back opcode pairs
+void OpcodeProfiler::report_pairs(uint64_t total_count) {
+    std::vector<int> order;
+    for (int i = 0; i < 0x10000; i++) {
+        if (pairs[i] != 0) {
+            order.push_back(i);
+        }
+    }
+    size_t shown = std::min<size_t>(order.size(), 20);
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(), [this](int a, int b) {
+        return pairs[a] > pairs[b];
+    });
+
+    std::cout << "pair           count     %count" << std::endl;
+    for (size_t i = 0; i < shown; i++) {
+        std::cout << std::hex << std::uppercase << std::setfill('0')
+                  << "   " << std::setw(2) << (order[i] >> 8) << " " << std::setw(2) << (order[i] & 0xFF)
+                  << std::dec << std::nouppercase << std::setfill(' ')
+                  << std::setw(12) << pairs[order[i]]
+                  << std::setw(10) << std::fixed << std::setprecision(2) << 100.0 * pairs[order[i]] / total_count << "%" << std::endl;
+    }
+}
+
+void OpcodeProfiler::write_csv(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Could not write opcode profile to " << path << std::endl;
+        return;
+    }
+    file << "prefix,opcode,count,cycles,taken,not_taken" << std::endl;
+    for (int i = 0; i < 512; i++) {
+        const Entry &entry = (i < 256) ? opcodes[i] : cb[i - 256];
+        if (entry.count == 0) {
+            continue;
+        }
+        bool branch = i < 256 && conditional(i);
+        file << (i < 256 ? "" : "CB") << ",0x" << std::hex << std::setw(2) << std::setfill('0') << (i & 0xFF)
+             << std::dec << "," << entry.count << "," << entry.cycles << ",";
+        if (branch) {
+            file << entry.taken << "," << entry.count - entry.taken;
+        } else {
+            file << ",";
+        }
+        file << std::endl;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Counts executions and cycles per opcode, CB opcodes separately, how often each
+// conditional branch is taken, and which opcodes follow each other (candidates for
+// superinstructions). The CPU feeds it from step() when built with
+// OPCODE_PROFILER (cmake -DENABLE_PROFILER=ON); otherwise it is never instantiated.
+// Instructions run inside JIT-translated blocks are not counted.
+class OpcodeProfiler {
+    public:
+        OpcodeProfiler(const std::string &csv_path = "opcode_profile.csv");
+        ~OpcodeProfiler();
+
+        void record(uint8_t opcode, uint8_t cb_opcode, int cycles, int base_cycles) {
+            pairs[previous << 8 | opcode]++;
+            previous = opcode;
+            Entry &entry = (opcode == 0xCB) ? cb[cb_opcode] : opcodes[opcode];
+            entry.count++;
+            entry.cycles += cycles;
+            if (cycles > base_cycles) {
+                entry.taken++; // Only conditional branches take longer than their base cost
+            }
+        }
+        void report();
+        void report_pairs(uint64_t total_count);
+        void write_csv(const std::string &path);
+
+    private:
+        struct Entry {
+            uint64_t count = 0;
+            uint64_t cycles = 0;
+            uint64_t taken = 0;
+        };
+
+        Entry opcodes[256];
+        Entry cb[256];
+        std::vector<uint64_t> pairs = std::vector<uint64_t>(0x10000); // Consecutive opcodes, first << 8 | second
+        uint8_t previous = 0;
+        std::string csv_path;
+
+        static bool conditional(uint8_t opcode);
+};
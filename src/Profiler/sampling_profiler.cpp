@@ -0,0 +1,133 @@
+#include "sampling_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+SamplingProfiler::SamplingProfiler(MMU *mmu, const std::string &path) {
+    this->mmu = mmu;
+    this->path = path;
+}
+
+// Dumps everything when the owning CPU goes away, i.e. when the emulator exits
+SamplingProfiler::~SamplingProfiler() {
+    report();
+    write_folded(path + ".folded");
+    write_hotspots(path + ".csv");
+}
+
+// Packs an address with what is mapped there: 0 above 0x7FFF, 1 for the boot ROM,
+// bank + 2 for cartridge ROM
+uint32_t SamplingProfiler::locate(uint16_t address) {
+    if (address >= 0x8000) {
+        return address;
+    }
+    if (address < 0x100 && !mmu->rom_disabled) {
+        return (1 << 16) | address;
+    }
+    return ((uint32_t)(mmu->cartridge->rom_bank(address) + 2) << 16) | address;
+}
+
+std::string SamplingProfiler::label(uint32_t location) {
+    char text[16];
+    uint32_t region = location >> 16;
+    if (region == 0) {
+        std::snprintf(text, sizeof(text), "%04X", location & 0xFFFF);
+    } else if (region == 1) {
+        std::snprintf(text, sizeof(text), "boot:%04X", location & 0xFFFF);
+    } else {
+        std::snprintf(text, sizeof(text), "%02X:%04X", region - 2, location & 0xFFFF);
+    }
+    return text;
+}
+
+void SamplingProfiler::call(uint16_t target, uint16_t sp) {
+    // Frames at or below the new return address were abandoned (SP reloaded, return
+    // address popped by hand, ...)
+    while (!stack.empty() && stack.back().sp <= sp) {
+        stack.pop_back();
+    }
+    if (stack.size() < MAX_DEPTH) {
+        stack.push_back({locate(target), sp});
+    }
+}
+
+void SamplingProfiler::ret(uint16_t sp) {
+    while (!stack.empty() && stack.back().sp < sp) {
+        stack.pop_back();
+    }
+}
+
+void SamplingProfiler::sample(uint16_t pc, uint16_t sp) {
+    ret(sp); // Drops routines left without a RET, e.g. through POP HL; JP HL
+    samples++;
+    hotspots[locate(pc)]++;
+    std::vector<uint32_t> frames;
+    frames.reserve(stack.size());
+    for (const Frame &frame : stack) {
+        frames.push_back(frame.location);
+    }
+    stacks[frames]++;
+}
+
+// Prints the most sampled addresses
+void SamplingProfiler::report() {
+    if (samples == 0) {
+        return;
+    }
+    std::vector<std::pair<uint32_t, uint64_t>> rows(hotspots.begin(), hotspots.end());
+    std::sort(rows.begin(), rows.end(), [](const std::pair<uint32_t, uint64_t> &a, const std::pair<uint32_t, uint64_t> &b) {
+        return a.second > b.second;
+    });
+    if (rows.size() > 20) {
+        rows.resize(20);
+    }
+
+    std::cout << std::dec << "PC samples: " << samples << " (every " << INTERVAL << " cycles)" << std::endl;
+    std::cout << "location      samples   %samples" << std::endl;
+    for (const std::pair<uint32_t, uint64_t> &row : rows) {
+        std::cout << std::left << std::setw(9) << label(row.first) << std::right
+                  << std::setw(12) << row.second
+                  << std::setw(10) << std::fixed << std::setprecision(2) << 100.0 * row.second / samples << "%" << std::endl;
+    }
+}
+
+// One line per distinct call stack, outermost frame first; samples taken outside any
+// tracked call land on "root"
+void SamplingProfiler::write_folded(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Could not write PC profile to " << path << std::endl;
+        return;
+    }
+    for (const auto &entry : stacks) {
+        file << "root";
+        for (uint32_t location : entry.first) {
+            file << ";" << label(location);
+        }
+        file << " " << entry.second << std::endl;
+    }
+}
+
+void SamplingProfiler::write_hotspots(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Could not write PC profile to " << path << std::endl;
+        return;
+    }
+    file << "bank,address,samples" << std::endl;
+    for (const std::pair<const uint32_t, uint64_t> &entry : hotspots) {
+        uint32_t region = entry.first >> 16;
+        if (region == 0) {
+            file << ",";
+        } else if (region == 1) {
+            file << "boot,";
+        } else {
+            file << region - 2 << ",";
+        }
+        file << "0x" << std::hex << std::setw(4) << std::setfill('0') << (entry.first & 0xFFFF)
+             << std::dec << std::setfill(' ') << "," << entry.second << std::endl;
+    }
+}
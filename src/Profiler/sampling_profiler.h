@@ -0,0 +1,63 @@
+#pragma once
+
+#include "MMU/MMU.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Samples the (ROM bank, PC) pair every INTERVAL emulated cycles. A shadow call stack
+// kept through CALL, RST, interrupts and RET/RETI turns the samples into folded stacks
+// ("frame;frame;frame count" lines) that flamegraph.pl, speedscope and similar tools
+// load directly. Built into the CPU with SAMPLING_PROFILER (cmake
+// -DENABLE_SAMPLING_PROFILER=ON). Calls made inside JIT-translated blocks are not seen.
+class SamplingProfiler {
+    public:
+        static constexpr int INTERVAL = 1021; // Prime, so loops can't line up with the samples
+        static constexpr size_t MAX_DEPTH = 64;
+
+        SamplingProfiler(MMU *mmu, const std::string &path = "pc_profile");
+        ~SamplingProfiler();
+
+        // Called with the cycles and start PC of every step, and SP after it
+        void advance(int cycles, uint16_t pc, uint16_t sp) {
+            countdown -= cycles;
+            if (countdown <= 0) {
+                countdown += INTERVAL;
+                sample(pc, sp);
+            }
+        }
+        // Called after every interpreted instruction with SP before and after it
+        void track(uint8_t opcode, uint16_t old_sp, uint16_t sp, uint16_t pc) {
+            if (sp == (uint16_t)(old_sp - 2) && (opcode == 0xCD || (opcode & 0xE7) == 0xC4 || (opcode & 0xC7) == 0xC7)) {
+                call(pc, sp); // CALL, CALL cc, RST
+            } else if (sp == (uint16_t)(old_sp + 2) && (opcode == 0xC9 || opcode == 0xD9 || (opcode & 0xE7) == 0xC0)) {
+                ret(sp); // RET, RETI, RET cc
+            }
+        }
+        void call(uint16_t target, uint16_t sp);
+        void ret(uint16_t sp);
+        void report();
+        void write_folded(const std::string &path);
+        void write_hotspots(const std::string &path);
+
+    private:
+        struct Frame {
+            uint32_t location; // Callee, see locate()
+            uint16_t sp;       // Where its return address lives
+        };
+
+        MMU *mmu;
+        std::string path;
+        int countdown = INTERVAL;
+        uint64_t samples = 0;
+        std::vector<Frame> stack;
+        std::unordered_map<uint32_t, uint64_t> hotspots;
+        std::map<std::vector<uint32_t>, uint64_t> stacks;
+
+        uint32_t locate(uint16_t address);
+        void sample(uint16_t pc, uint16_t sp);
+        static std::string label(uint32_t location);
+};
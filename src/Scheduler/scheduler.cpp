@@ -1,51 +1,144 @@
 #include "scheduler.h"
+#include "PPU/PPU.h"
+
+#include <algorithm>
 
 Scheduler::Scheduler(MMU *mmu) {
     this->mmu = mmu;
-    DIV = TIMA = TMA = TAC = 0;
-    timer_cycles = divider_cycles = 0;
-}
-
-void Scheduler::increment(uint8_t cycles) {
-    mmu->timer_cycles += cycles;
-    mmu->timer_cycles %= 4194304; // Game Boy Ticks
-    DIV += cycles;
-    while ((int)DIV >= 256) {
-        DIV -= 256;
-        mmu->DIV += 1;
-    }
-
-    if (mmu->TAC & 0x04) {
-        TIMA += cycles;
-        int threshold = 0;
-        switch (mmu->TAC & 0x03) {
-            case 0: {
-                threshold = 1024;
-                break;
-            } case 1: {
-                threshold = 16;
-                break;
-            } case 2: {
-                threshold = 64;
-                break;
-            } case 3: {
-                threshold = 256;
-                break;
-            }
-        }
-        while (TIMA >= threshold) {
-            TIMA -= threshold;
-            if (mmu->TIMA == 0xFF) {
-                mmu->TIMA = mmu->read_byte(0xFF06);
+    for (uint64_t &deadline : deadlines) {
+        deadline = NEVER;
+    }
+    next_deadline = NEVER;
+    for (uint16_t address = 0xFF04; address <= 0xFF07; address++) {
+        mmu->register_io(address, this, read_timer, write_timer);
+    }
+    register_event(EVENT_TIMER, this, timer_overflow);
+    mmu->scheduler = this;
+    register_event(EVENT_DMA, mmu, MMU::finish_dma);
+}
+
+// Routes event to run, called with owner
+void Scheduler::register_event(Event event, void *owner, EventHandler run) {
+    handlers[event] = {run, owner};
+}
+
+// Sets when event next runs, replacing any earlier deadline for it
+void Scheduler::schedule(Event event, uint64_t deadline) {
+    deadlines[event] = deadline;
+    queue.push({deadline, event});
+    drop_stale();
+}
+
+void Scheduler::cancel(Event event) {
+    deadlines[event] = NEVER;
+    drop_stale();
+}
+
+void Scheduler::run_events() {
+    while (next_deadline <= cycles) {
+        Entry entry = queue.top();
+        queue.pop();
+        deadlines[entry.second] = NEVER; // Handlers may schedule it again
+        const Handler &handler = handlers[entry.second];
+        handler.run(handler.owner, entry.first);
+        drop_stale();
+    }
+}
+
+void Scheduler::drop_stale() {
+    while (!queue.empty() && deadlines[queue.top().second] != queue.top().first) {
+        queue.pop();
+    }
+    next_deadline = queue.empty() ? NEVER : queue.top().first;
+}
+
+uint8_t Scheduler::read_timer(void *scheduler, uint16_t address) {
+    return ((Scheduler*)scheduler)->timer_register(address);
+}
+
+// Any write to DIV resets it
+void Scheduler::write_timer(void *scheduler, uint16_t address, uint8_t value) {
+    Scheduler *self = (Scheduler*)scheduler;
+    self->sync_timer();
+    switch (address) {
+        case 0xFF04: self->div_offset = -(uint8_t)(self->cycles >> 8); break;
+        case 0xFF05: self->TIMA = value; break;
+        case 0xFF06: self->TMA = value; break;
+        default: self->TAC = value; break;
+    }
+    self->schedule_timer();
+}
+
+void Scheduler::timer_overflow(void *scheduler, uint64_t deadline) {
+    Scheduler *self = (Scheduler*)scheduler;
+    (void)deadline;
+    self->sync_timer();
+    self->schedule_timer();
+}
+
+// Current value of the timer register at address (0xFF04-0xFF07)
+uint8_t Scheduler::timer_register(uint16_t address) {
+    sync_timer();
+    switch (address) {
+        case 0xFF04: return div_offset + (uint8_t)(cycles >> 8);
+        case 0xFF05: return TIMA;
+        case 0xFF06: return TMA;
+        default: return TAC;
+    }
+}
+
+void Scheduler::reset_timer(uint8_t div, uint8_t tima, uint8_t tma, uint8_t tac) {
+    sync_timer();
+    div_offset = div - (uint8_t)(cycles >> 8);
+    TIMA = tima;
+    TMA = tma;
+    TAC = tac;
+    schedule_timer();
+}
+
+// Cycles per TIMA increment for the clock selected in TAC
+int Scheduler::timer_period() {
+    switch (TAC & 0x03) {
+        case 0: return 1024;
+        case 1: return 16;
+        case 2: return 64;
+        default: return 256;
+    }
+}
+
+// Brings TIMA up to the current cycle count, reloading it from TMA and requesting
+// the timer interrupt on every overflow on the way
+void Scheduler::sync_timer() {
+    if (TAC & 0x04) {
+        timer_cycles += cycles - timer_synced;
+        int period = timer_period();
+        int ticks = timer_cycles / period;
+        timer_cycles -= ticks * period;
+        while (ticks > 0) {
+            int step = std::min(ticks, 0x100 - TIMA);
+            ticks -= step;
+            if (TIMA + step == 0x100) {
+                TIMA = TMA;
                 mmu->set_interrupt_flag(mmu->TIMER);
             } else {
-                mmu->TIMA++;
+                TIMA += step;
             }
         }
     }
+    timer_synced = cycles;
+}
+
+// Schedules the next TIMA overflow, call after sync_timer
+void Scheduler::schedule_timer() {
+    if (TAC & 0x04) {
+        schedule(EVENT_TIMER, cycles + (0x100 - TIMA) * timer_period() - timer_cycles);
+    } else {
+        cancel(EVENT_TIMER);
+    }
 }
 
 void Scheduler::info() {
     std::cout << "Scheduler Info:" << std::endl;
-    std::cout << std::dec <<  "DIV: " << (int)DIV << " TIMA"  << (int)TIMA << " TMA: " << (int)TMA << " TAC: " << (int)TAC << std::endl;
-}
\ No newline at end of file
+    std::cout << std::dec << "DIV: " << (int)timer_register(0xFF04) << " TIMA: " << (int)timer_register(0xFF05)
+              << " TMA: " << (int)TMA << " TAC: " << (int)TAC << std::endl;
+}
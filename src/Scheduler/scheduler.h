@@ -1,12 +1,91 @@
 #pragma once
 #include "MMU/MMU.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+class PPU;
+
+// Timestamped work the scheduler runs once the cycle count reaches it. Events due
+// at the same cycle run in this order.
+enum Event : uint8_t {
+    EVENT_DMA,   // OAM DMA completion
+    EVENT_TIMER, // TIMA overflow
+    EVENT_PPU,   // PPU mode change
+    EVENT_COUNT,
+};
+
+// Runs a due event. deadline is the cycle it was due at, which may be a few cycles
+// behind the current count since events run at instruction boundaries.
+typedef void (*EventHandler)(void *owner, uint64_t deadline);
+
+// Keeps the cycle count and a min-heap of pending events, at most one per kind.
+// Components schedule their own next event instead of being stepped every
+// instruction, so between deadlines an instruction only costs increment()'s add and
+// compare. The timer is lazy as well: DIV and TIMA are worked out from the cycle
+// count when read, and only a TIMA overflow is an event.
 class Scheduler {
     MMU* mmu;
-    int DIV, TIMA, TMA, TAC; // Timer Registers
-    int timer_cycles, divider_cycles; // Timer & Divider Cycles
+    static uint8_t read_timer(void *scheduler, uint16_t address);
+    static void write_timer(void *scheduler, uint16_t address, uint8_t value);
+    static void timer_overflow(void *scheduler, uint64_t deadline);
+
+    struct Handler {
+        EventHandler run;
+        void *owner;
+    };
+    Handler handlers[EVENT_COUNT] = {};
+    uint64_t deadlines[EVENT_COUNT];
+    // Rescheduling or cancelling an event leaves its old entry in the heap, where it
+    // no longer matches deadlines[] and is dropped when it reaches the top
+    typedef std::pair<uint64_t, Event> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    uint64_t next_deadline; // Of the earliest pending event
+
+    uint8_t div_offset = 0;  // DIV is div_offset plus the cycle count / 256
+    uint8_t TIMA = 0;        // As of timer_synced
+    int timer_cycles = 0;    // Towards the next TIMA increment, as of timer_synced
+    uint64_t timer_synced = 0;
+    uint8_t TMA = 0, TAC = 0;
+
+    void run_events();
+    void drop_stale();
+    int timer_period();
+    void sync_timer();
+    void schedule_timer();
+
     public:
+        static constexpr int MAX_IDLE_CYCLES = 70224; // One frame
+        static constexpr uint64_t NEVER = UINT64_MAX;
+
+        uint64_t cycles = 0; // Since power on
+
+        PPU *ppu = nullptr; // Set by the PPU, the busy-wait and bulk loop shortcuts need it
         Scheduler(MMU *mmu);
-        void increment(uint8_t cycles);
+        void register_event(Event event, void *owner, EventHandler run);
+        void schedule(Event event, uint64_t deadline);
+        void cancel(Event event);
+        void increment(int cycles) {
+            this->cycles += cycles;
+            if (this->cycles >= next_deadline) {
+                run_events();
+            }
+        }
+        // Cycles until the next event, rounded up to whole machine cycles. Nothing else
+        // changes the timer, PPU or interrupt flags, so a HALT can skip straight there
+        // and busy-wait and bulk loops can run that far in one go.
+        int cycles_until_next_event() {
+            int64_t cycles = MAX_IDLE_CYCLES;
+            if (next_deadline != NEVER) {
+                cycles = std::min<int64_t>(cycles, (int64_t)(next_deadline - this->cycles));
+            }
+            return std::max<int>(4, (cycles + 3) & ~3);
+        }
+        uint8_t timer_register(uint16_t address);
+        void reset_timer(uint8_t div, uint8_t tima, uint8_t tma, uint8_t tac);
         void info();
-};
\ No newline at end of file
+};